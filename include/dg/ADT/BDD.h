@@ -0,0 +1,344 @@
+#ifndef DG_ADT_BDD_H_
+#define DG_ADT_BDD_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dg/ADT/ConcurrentVector.h"
+
+namespace dg {
+namespace ADT {
+
+///
+// A small package of reduced ordered binary decision diagrams
+// that represent sets of numbers. A number is encoded by the values
+// of 'varsNum' boolean variables, the 0-th variable is the most
+// significant bit. The diagrams are shared (equal sets are the same
+// node) and the nodes are never freed until the manager is destroyed.
+// The results of operations are kept in a cache that grows
+// with the number of nodes.
+class BDD {
+  public:
+    using NodeID = uint32_t;
+    // the empty set and the set of all numbers
+    enum : NodeID { FALSE = 0, TRUE = 1 };
+
+  private:
+    struct Node {
+        unsigned var;
+        NodeID low, high;
+    };
+
+    static size_t hash(unsigned v, NodeID low, NodeID high) {
+        return (low * 0x9e3779b97f4a7c15ULL) ^ (high * 0xc2b2ae3d27d4eb4fULL) ^
+               v;
+    }
+
+    enum class Op : unsigned { NONE, OR, AND, DIFF };
+
+    struct CacheEntry {
+        Op op{Op::NONE};
+        NodeID a{0}, b{0}, res{0};
+    };
+
+    static const size_t MIN_CACHE_SIZE = 1 << 8;
+    static const size_t MAX_CACHE_SIZE = 1 << 18;
+
+    const unsigned _varsNum;
+    // the nodes never move, so they can be read without locking
+    ConcurrentVector<Node> _nodes;
+    // the unique table: open addressing with IDs of the nodes,
+    // 0 (FALSE) is an empty slot, the size is a power of two
+    std::vector<NodeID> _unique;
+    // allocated on the first operation, the size is a power of two
+    std::vector<CacheEntry> _cache;
+
+    mutable std::mutex _lock;
+    bool _concurrent{false};
+
+    const Node &node(NodeID n) const { return _nodes[n]; }
+
+    // the terminal nodes are below all variables
+    unsigned var(NodeID n) const { return node(n).var; }
+
+    NodeID mk(unsigned v, NodeID low, NodeID high) {
+        if (low == high)
+            return low;
+
+        // keep the load under 1/2
+        if (2 * _nodes.size() >= _unique.size())
+            rehash();
+
+        const size_t mask = _unique.size() - 1;
+        size_t i = hash(v, low, high) & mask;
+        for (; _unique[i] != FALSE; i = (i + 1) & mask) {
+            const Node &N = node(_unique[i]);
+            if (N.var == v && N.low == low && N.high == high)
+                return _unique[i];
+        }
+
+        auto id = static_cast<NodeID>(_nodes.push_back({v, low, high}));
+        _unique[i] = id;
+        return id;
+    }
+
+    void rehash() {
+        std::vector<NodeID> table(std::max<size_t>(_unique.size() * 2, 1024),
+                                  FALSE);
+        const size_t mask = table.size() - 1;
+        // skip the terminal nodes
+        for (NodeID id = 2; id < _nodes.size(); ++id) {
+            const Node &N = node(id);
+            size_t i = hash(N.var, N.low, N.high) & mask;
+            while (table[i] != FALSE)
+                i = (i + 1) & mask;
+            table[i] = id;
+        }
+        _unique.swap(table);
+    }
+
+    // the terminal cases of the operations
+    static bool terminal(Op op, NodeID a, NodeID b, NodeID &res) {
+        switch (op) {
+        case Op::OR:
+            if (a == TRUE || b == TRUE)
+                res = TRUE;
+            else if (a == FALSE || a == b)
+                res = b;
+            else if (b == FALSE)
+                res = a;
+            else
+                return false;
+            return true;
+        case Op::AND:
+            if (a == FALSE || b == FALSE)
+                res = FALSE;
+            else if (a == TRUE || a == b)
+                res = b;
+            else if (b == TRUE)
+                res = a;
+            else
+                return false;
+            return true;
+        case Op::DIFF:
+            if (a == FALSE || b == TRUE || a == b)
+                res = FALSE;
+            else if (b == FALSE)
+                res = a;
+            else
+                return false;
+            return true;
+        default:
+            assert(false && "Invalid operation");
+            abort();
+        }
+    }
+
+    NodeID apply(Op op, NodeID a, NodeID b) {
+        NodeID res;
+        if (terminal(op, a, b, res))
+            return res;
+
+        // OR and AND are commutative
+        if (op != Op::DIFF && b < a)
+            std::swap(a, b);
+
+        const size_t h = (a * 12582917ULL + b * 4256249ULL +
+                          static_cast<unsigned>(op)) &
+                         (_cache.size() - 1);
+        auto &entry = _cache[h];
+        if (entry.op == op && entry.a == a && entry.b == b)
+            return entry.res;
+
+        const unsigned v = std::min(var(a), var(b));
+        const NodeID al = var(a) == v ? node(a).low : a;
+        const NodeID ah = var(a) == v ? node(a).high : a;
+        const NodeID bl = var(b) == v ? node(b).low : b;
+        const NodeID bh = var(b) == v ? node(b).high : b;
+
+        res = mk(v, apply(op, al, bl), apply(op, ah, bh));
+        // the recursion may have overwritten the entry
+        auto &e = _cache[h];
+        e.op = op;
+        e.a = a;
+        e.b = b;
+        e.res = res;
+        return res;
+    }
+
+    NodeID locked_apply(Op op, NodeID a, NodeID b) {
+        NodeID res;
+        if (terminal(op, a, b, res))
+            return res;
+
+        std::unique_lock<std::mutex> guard(_lock, std::defer_lock);
+        if (_concurrent)
+            guard.lock();
+
+        if (_cache.size() < MAX_CACHE_SIZE &&
+            _cache.size() < _nodes.size()) {
+            // the old entries would be at wrong places, drop them
+            size_t size = _cache.empty() ? MIN_CACHE_SIZE : _cache.size();
+            while (size < _nodes.size() && size < MAX_CACHE_SIZE)
+                size <<= 1;
+            _cache.assign(size, CacheEntry());
+        }
+        return apply(op, a, b);
+    }
+
+    NodeID insert(NodeID n, unsigned v, uint64_t value) {
+        if (n == TRUE || v == _varsNum)
+            return TRUE;
+
+        // if the variable is skipped, both branches are 'n'
+        NodeID low = n, high = n;
+        if (var(n) == v) {
+            low = node(n).low;
+            high = node(n).high;
+        }
+
+        if ((value >> (_varsNum - 1 - v)) & 0x1)
+            high = insert(high, v + 1, value);
+        else
+            low = insert(low, v + 1, value);
+        return mk(v, low, high);
+    }
+
+    // the number of numbers in the set 'n' restricted to the variables
+    // from var(n) to the last one
+    uint64_t count(NodeID n,
+                   std::unordered_map<NodeID, uint64_t> &memo) const {
+        if (n == FALSE)
+            return 0;
+        if (n == TRUE)
+            return 1;
+
+        auto it = memo.find(n);
+        if (it != memo.end())
+            return it->second;
+
+        const Node &N = node(n);
+        // the skipped variables may have any value
+        uint64_t ret = (count(N.low, memo) << (var(N.low) - N.var - 1)) +
+                       (count(N.high, memo) << (var(N.high) - N.var - 1));
+        memo.emplace(n, ret);
+        return ret;
+    }
+
+    template <typename FunT>
+    void enumerate(NodeID n, unsigned v, uint64_t value, const FunT &F) const {
+        if (n == FALSE)
+            return;
+        if (v == _varsNum) {
+            assert(n == TRUE);
+            F(value);
+            return;
+        }
+
+        // the lower values first
+        const Node &N = node(n);
+        if (N.var == v) {
+            enumerate(N.low, v + 1, value << 1, F);
+            enumerate(N.high, v + 1, (value << 1) | 1, F);
+        } else {
+            // the variable does not matter
+            enumerate(n, v + 1, value << 1, F);
+            enumerate(n, v + 1, (value << 1) | 1, F);
+        }
+    }
+
+  public:
+    explicit BDD(unsigned varsNum = 32) : _varsNum(varsNum) {
+        assert(varsNum > 0 && varsNum < 64);
+        // the terminal nodes
+        _nodes.push_back({varsNum, FALSE, FALSE});
+        _nodes.push_back({varsNum, TRUE, TRUE});
+    }
+
+    BDD(const BDD &) = delete;
+    BDD &operator=(const BDD &) = delete;
+
+    // Use locking so that the diagrams can be created from multiple threads
+    void setConcurrent(bool b) { _concurrent = b; }
+
+    unsigned getVarsNum() const { return _varsNum; }
+
+    // the set {value}
+    NodeID singleton(uint64_t value) {
+        assert(value < (uint64_t{1} << _varsNum) && "Too big value");
+
+        std::unique_lock<std::mutex> guard(_lock, std::defer_lock);
+        if (_concurrent)
+            guard.lock();
+
+        NodeID n = TRUE;
+        for (unsigned v = _varsNum; v-- > 0; value >>= 1) {
+            n = (value & 0x1) ? mk(v, FALSE, n) : mk(v, n, FALSE);
+        }
+        return n;
+    }
+
+    // the set n \cup {value}, cheaper than the union with the singleton
+    NodeID insert(NodeID n, uint64_t value) {
+        assert(value < (uint64_t{1} << _varsNum) && "Too big value");
+
+        std::unique_lock<std::mutex> guard(_lock, std::defer_lock);
+        if (_concurrent)
+            guard.lock();
+
+        return insert(n, 0, value);
+    }
+
+    NodeID unite(NodeID a, NodeID b) { return locked_apply(Op::OR, a, b); }
+    NodeID intersect(NodeID a, NodeID b) {
+        return locked_apply(Op::AND, a, b);
+    }
+    // a \ b
+    NodeID subtract(NodeID a, NodeID b) {
+        return locked_apply(Op::DIFF, a, b);
+    }
+
+    bool contains(NodeID n, uint64_t value) const {
+        if (value >= (uint64_t{1} << _varsNum))
+            return false;
+
+        while (n != FALSE && n != TRUE) {
+            const Node &N = node(n);
+            n = (value >> (_varsNum - 1 - N.var)) & 0x1 ? N.high : N.low;
+        }
+        return n == TRUE;
+    }
+
+    // the number of numbers in the set
+    uint64_t count(NodeID n) const {
+        std::unordered_map<NodeID, uint64_t> memo;
+        return count(n, memo) << var(n);
+    }
+
+    // call F on the numbers in the set in increasing order
+    template <typename FunT>
+    void enumerate(NodeID n, const FunT &F) const {
+        enumerate(n, 0, 0, F);
+    }
+
+    // the number of nodes (including the terminal nodes)
+    size_t size() const { return _nodes.size(); }
+
+    // approximate memory used by the diagrams
+    size_t memoryUsage() const {
+        return _nodes.size() * sizeof(Node) +
+               _unique.size() * sizeof(NodeID) +
+               _cache.size() * sizeof(CacheEntry);
+    }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_BDD_H_
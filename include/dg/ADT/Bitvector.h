@@ -24,13 +24,14 @@ class SparseBitvectorImpl {
     static ShiftT _shift(IndexT i) { return i - (i % BITS_IN_BUCKET); }
 
     static size_t _countBits(BitsT bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (sizeof(BitsT) <= sizeof(unsigned long long))
+            return __builtin_popcountll(bits);
+#endif
         size_t num = 0;
-        while (bits) {
-            if (bits & 0x1)
-                ++num;
-
-            bits = bits >> 1;
-        }
+        // clear the lowest set bit until there is some
+        for (; bits; bits &= bits - 1)
+            ++num;
 
         return num;
     }
@@ -0,0 +1,475 @@
+#ifndef DG_CHUNKED_BITVECTOR_H_
+#define DG_CHUNKED_BITVECTOR_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace dg {
+namespace ADT {
+
+using std::size_t;
+
+// Operations on blocks of WORDS 64-bit words. They use AVX2 or SSE2
+// if the compiler is allowed to use them (e.g., with -march=native)
+// and plain loops otherwise.
+template <size_t WORDS>
+struct BitBlockOps {
+    static size_t popcount(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(w);
+#else
+        size_t num = 0;
+        for (; w; w &= w - 1)
+            ++num;
+        return num;
+#endif
+    }
+
+    static size_t countTrailingZeros(uint64_t w) {
+        assert(w != 0);
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(w);
+#else
+        size_t num = 0;
+        for (; !(w & 0x1); w >>= 1)
+            ++num;
+        return num;
+#endif
+    }
+
+    static size_t count(const uint64_t *a) {
+        size_t num = 0;
+        for (size_t i = 0; i < WORDS; ++i)
+            num += popcount(a[i]);
+        return num;
+    }
+
+    static bool isZero(const uint64_t *a) {
+        uint64_t acc = 0;
+        for (size_t i = 0; i < WORDS; ++i)
+            acc |= a[i];
+        return acc == 0;
+    }
+
+    // a |= b, return true if a changed
+    static bool unite(uint64_t *a, const uint64_t *b) {
+#if defined(__AVX2__)
+        if (WORDS % 4 == 0) {
+            bool changed = false;
+            for (size_t i = 0; i < WORDS; i += 4) {
+                auto *pa = reinterpret_cast<__m256i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m256i *>(b + i);
+                __m256i va = _mm256_loadu_si256(pa);
+                __m256i vb = _mm256_loadu_si256(pb);
+                // testc is 1 iff (~va & vb) == 0
+                changed |= !_mm256_testc_si256(va, vb);
+                _mm256_storeu_si256(pa, _mm256_or_si256(va, vb));
+            }
+            return changed;
+        }
+#elif defined(__SSE2__)
+        if (WORDS % 2 == 0) {
+            int unchanged = 0xffff;
+            for (size_t i = 0; i < WORDS; i += 2) {
+                auto *pa = reinterpret_cast<__m128i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m128i *>(b + i);
+                __m128i va = _mm_loadu_si128(pa);
+                __m128i vr = _mm_or_si128(va, _mm_loadu_si128(pb));
+                unchanged &= _mm_movemask_epi8(_mm_cmpeq_epi8(va, vr));
+                _mm_storeu_si128(pa, vr);
+            }
+            return unchanged != 0xffff;
+        }
+#endif
+        uint64_t diff = 0;
+        for (size_t i = 0; i < WORDS; ++i) {
+            diff |= b[i] & ~a[i];
+            a[i] |= b[i];
+        }
+        return diff != 0;
+    }
+
+    // a &= b, return true if a is not zero afterwards
+    static bool intersect(uint64_t *a, const uint64_t *b) {
+#if defined(__AVX2__)
+        if (WORDS % 4 == 0) {
+            __m256i acc = _mm256_setzero_si256();
+            for (size_t i = 0; i < WORDS; i += 4) {
+                auto *pa = reinterpret_cast<__m256i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m256i *>(b + i);
+                __m256i vr = _mm256_and_si256(_mm256_loadu_si256(pa),
+                                              _mm256_loadu_si256(pb));
+                acc = _mm256_or_si256(acc, vr);
+                _mm256_storeu_si256(pa, vr);
+            }
+            return !_mm256_testz_si256(acc, acc);
+        }
+#elif defined(__SSE2__)
+        if (WORDS % 2 == 0) {
+            __m128i acc = _mm_setzero_si128();
+            for (size_t i = 0; i < WORDS; i += 2) {
+                auto *pa = reinterpret_cast<__m128i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m128i *>(b + i);
+                __m128i vr = _mm_and_si128(_mm_loadu_si128(pa),
+                                           _mm_loadu_si128(pb));
+                acc = _mm_or_si128(acc, vr);
+                _mm_storeu_si128(pa, vr);
+            }
+            return _mm_movemask_epi8(
+                           _mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xffff;
+        }
+#endif
+        uint64_t acc = 0;
+        for (size_t i = 0; i < WORDS; ++i) {
+            a[i] &= b[i];
+            acc |= a[i];
+        }
+        return acc != 0;
+    }
+
+    // (a & b) != 0
+    static bool intersects(const uint64_t *a, const uint64_t *b) {
+#if defined(__AVX2__)
+        if (WORDS % 4 == 0) {
+            for (size_t i = 0; i < WORDS; i += 4) {
+                const auto *pa = reinterpret_cast<const __m256i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m256i *>(b + i);
+                if (!_mm256_testz_si256(_mm256_loadu_si256(pa),
+                                        _mm256_loadu_si256(pb)))
+                    return true;
+            }
+            return false;
+        }
+#endif
+        for (size_t i = 0; i < WORDS; ++i) {
+            if (a[i] & b[i])
+                return true;
+        }
+        return false;
+    }
+
+    // (a & ~b) == 0
+    static bool isSubset(const uint64_t *a, const uint64_t *b) {
+#if defined(__AVX2__)
+        if (WORDS % 4 == 0) {
+            for (size_t i = 0; i < WORDS; i += 4) {
+                const auto *pa = reinterpret_cast<const __m256i *>(a + i);
+                const auto *pb = reinterpret_cast<const __m256i *>(b + i);
+                // testc is 1 iff (~vb & va) == 0
+                if (!_mm256_testc_si256(_mm256_loadu_si256(pb),
+                                        _mm256_loadu_si256(pa)))
+                    return false;
+            }
+            return true;
+        }
+#endif
+        for (size_t i = 0; i < WORDS; ++i) {
+            if (a[i] & ~b[i])
+                return false;
+        }
+        return true;
+    }
+};
+
+///
+// Bitvector stored as a sorted array of blocks of BLOCK_BITS bits.
+// Only the blocks with some bit set are stored. Unlike
+// SparseBitvectorImpl, union, intersection and the subset test
+// go over the arrays linearly and work on whole blocks at once,
+// which is fast if the indices are dense (e.g., IDs of pointers).
+template <size_t BLOCK_BITS = 256>
+class ChunkedBitvectorImpl {
+    static_assert(BLOCK_BITS % 64 == 0, "Invalid size of blocks");
+
+    using IndexT = uint64_t;
+    static const size_t WORDS = BLOCK_BITS / 64;
+    using Ops = BitBlockOps<WORDS>;
+
+    struct Block {
+        // the index of the first bit in the block
+        IndexT base;
+        uint64_t words[WORDS];
+
+        explicit Block(IndexT b) : base(b) {
+            std::memset(words, 0, sizeof(words));
+        }
+    };
+
+    std::vector<Block> _blocks;
+
+    static IndexT _base(IndexT i) { return i - (i % BLOCK_BITS); }
+
+    static uint64_t _mask(IndexT i) { return uint64_t{1} << (i % 64); }
+
+    static size_t _word(IndexT i) { return (i % BLOCK_BITS) / 64; }
+
+    typename std::vector<Block>::iterator _find(IndexT base) {
+        return std::lower_bound(
+                _blocks.begin(), _blocks.end(), base,
+                [](const Block &B, IndexT b) { return B.base < b; });
+    }
+
+    typename std::vector<Block>::const_iterator _find(IndexT base) const {
+        return std::lower_bound(
+                _blocks.begin(), _blocks.end(), base,
+                [](const Block &B, IndexT b) { return B.base < b; });
+    }
+
+  public:
+    ChunkedBitvectorImpl() = default;
+    ChunkedBitvectorImpl(IndexT i) { set(i); } // singleton ctor
+
+    ChunkedBitvectorImpl(const ChunkedBitvectorImpl &) = default;
+    ChunkedBitvectorImpl(ChunkedBitvectorImpl &&) = default;
+    ChunkedBitvectorImpl &operator=(const ChunkedBitvectorImpl &) = default;
+    ChunkedBitvectorImpl &operator=(ChunkedBitvectorImpl &&) = default;
+
+    void reset() { _blocks.clear(); }
+    bool empty() const { return _blocks.empty(); }
+    void swap(ChunkedBitvectorImpl &oth) { _blocks.swap(oth._blocks); }
+
+    // reserve space for n bits (so it is compatible
+    // with SparseBitvectorImpl::reserve)
+    void reserve(size_t n) {
+        _blocks.reserve((n + BLOCK_BITS - 1) / BLOCK_BITS);
+    }
+
+    bool get(IndexT i) const {
+        auto it = _find(_base(i));
+        if (it == _blocks.end() || it->base != _base(i))
+            return false;
+        return it->words[_word(i)] & _mask(i);
+    }
+
+    // returns the previous value of the i-th bit
+    bool set(IndexT i) {
+        auto it = _find(_base(i));
+        if (it == _blocks.end() || it->base != _base(i))
+            it = _blocks.insert(it, Block(_base(i)));
+
+        auto &W = it->words[_word(i)];
+        bool prev = W & _mask(i);
+        W |= _mask(i);
+        return prev;
+    }
+
+    // union operation
+    bool set(const ChunkedBitvectorImpl &rhs) {
+        if (rhs.empty())
+            return false;
+
+        // merge the blocks that we have and count those that we miss
+        size_t missing = 0;
+        bool changed = false;
+        auto it = _blocks.begin();
+        for (const auto &B : rhs._blocks) {
+            while (it != _blocks.end() && it->base < B.base)
+                ++it;
+            if (it != _blocks.end() && it->base == B.base)
+                changed |= Ops::unite(it->words, B.words);
+            else
+                ++missing;
+        }
+
+        if (missing == 0)
+            return changed;
+
+        // add the missing blocks
+        std::vector<Block> blocks;
+        blocks.reserve(_blocks.size() + missing);
+        std::merge(_blocks.begin(), _blocks.end(), rhs._blocks.begin(),
+                   rhs._blocks.end(), std::back_inserter(blocks),
+                   [](const Block &A, const Block &B) {
+                       return A.base < B.base;
+                   });
+        // the blocks that we had were merged already,
+        // so remove the duplicates (ours go first)
+        blocks.erase(std::unique(blocks.begin(), blocks.end(),
+                                 [](const Block &A, const Block &B) {
+                                     return A.base == B.base;
+                                 }),
+                     blocks.end());
+        _blocks.swap(blocks);
+        return true;
+    }
+
+    // intersection, returns true if some bit was removed
+    bool intersect(const ChunkedBitvectorImpl &rhs) {
+        bool changed = false;
+        auto rit = rhs._blocks.begin();
+        auto out = _blocks.begin();
+        for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
+            while (rit != rhs._blocks.end() && rit->base < it->base)
+                ++rit;
+
+            if (rit == rhs._blocks.end() || rit->base != it->base) {
+                changed = true;
+                continue;
+            }
+
+            changed |= !Ops::isSubset(it->words, rit->words);
+            if (Ops::intersect(it->words, rit->words))
+                *out++ = *it;
+        }
+        _blocks.erase(out, _blocks.end());
+        return changed;
+    }
+
+    // do the bitvectors have a common bit?
+    bool intersects(const ChunkedBitvectorImpl &rhs) const {
+        auto rit = rhs._blocks.begin();
+        for (const auto &B : _blocks) {
+            while (rit != rhs._blocks.end() && rit->base < B.base)
+                ++rit;
+            if (rit == rhs._blocks.end())
+                return false;
+            if (rit->base == B.base && Ops::intersects(B.words, rit->words))
+                return true;
+        }
+        return false;
+    }
+
+    // is every bit of this bitvector set in rhs?
+    bool isSubsetOf(const ChunkedBitvectorImpl &rhs) const {
+        auto rit = rhs._blocks.begin();
+        for (const auto &B : _blocks) {
+            while (rit != rhs._blocks.end() && rit->base < B.base)
+                ++rit;
+            if (rit == rhs._blocks.end() || rit->base != B.base)
+                return false;
+            if (!Ops::isSubset(B.words, rit->words))
+                return false;
+        }
+        return true;
+    }
+
+    // returns the previous value of the i-th bit
+    bool unset(IndexT i) {
+        auto it = _find(_base(i));
+        if (it == _blocks.end() || it->base != _base(i))
+            return false;
+
+        auto &W = it->words[_word(i)];
+        bool prev = W & _mask(i);
+        W &= ~_mask(i);
+        if (Ops::isZero(it->words))
+            _blocks.erase(it);
+
+        assert(get(i) == 0 && "Failed removing");
+        return prev;
+    }
+
+    size_t size() const {
+        size_t num = 0;
+        for (const auto &B : _blocks)
+            num += Ops::count(B.words);
+        return num;
+    }
+
+    bool operator==(const ChunkedBitvectorImpl &rhs) const {
+        if (_blocks.size() != rhs._blocks.size())
+            return false;
+        for (size_t i = 0; i < _blocks.size(); ++i) {
+            if (_blocks[i].base != rhs._blocks[i].base ||
+                std::memcmp(_blocks[i].words, rhs._blocks[i].words,
+                            sizeof(_blocks[i].words)) != 0)
+                return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const ChunkedBitvectorImpl &rhs) const {
+        return !operator==(rhs);
+    }
+
+    class const_iterator {
+        const Block *block{nullptr};
+        const Block *blocks_end{nullptr};
+        // the index of the current word and the bits of the word
+        // that were not visited yet
+        size_t word{0};
+        uint64_t bits{0};
+
+        const_iterator(const std::vector<Block> &blocks, bool end = false)
+                : block(blocks.data() + (end ? blocks.size() : 0)),
+                  blocks_end(blocks.data() + blocks.size()) {
+            if (block != blocks_end) {
+                bits = block->words[0];
+                _findClosestBit();
+            }
+        }
+
+        void _findClosestBit() {
+            while (bits == 0) {
+                if (++word == WORDS) {
+                    word = 0;
+                    if (++block == blocks_end)
+                        return;
+                }
+                bits = block->words[word];
+            }
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IndexT;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const IndexT *;
+        using reference = IndexT;
+
+        const_iterator() = default;
+
+        const_iterator &operator++() {
+            assert(block != blocks_end && "operator++ called on end");
+            // clear the lowest set bit
+            bits &= bits - 1;
+            _findClosestBit();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        IndexT operator*() const {
+            return block->base + word * 64 + Ops::countTrailingZeros(bits);
+        }
+
+        bool operator==(const const_iterator &rhs) const {
+            return block == rhs.block && word == rhs.word && bits == rhs.bits;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class ChunkedBitvectorImpl;
+    };
+
+    const_iterator begin() const { return const_iterator(_blocks); }
+    const_iterator end() const {
+        return const_iterator(_blocks, true /* end */);
+    }
+
+    friend class const_iterator;
+};
+
+using ChunkedBitvector = ChunkedBitvectorImpl<256>;
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_CHUNKED_BITVECTOR_H_
@@ -0,0 +1,98 @@
+#ifndef DG_ADT_CONCURRENT_VECTOR_H_
+#define DG_ADT_CONCURRENT_VECTOR_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+
+namespace dg {
+namespace ADT {
+
+///
+// An append-only vector whose elements never move in the memory.
+// Elements can be read while other threads append to the vector,
+// but the readers must get the index of the element in a way that
+// synchronizes with the append (e.g., via a locked map or a join
+// of threads). The elements are stored in segments, the k-th segment
+// has 2^k * FIRST_SEGMENT_SIZE elements.
+template <typename ValueT>
+class ConcurrentVector {
+    static const size_t FIRST_SEGMENT_BITS = 10;
+    static const size_t FIRST_SEGMENT_SIZE = 1UL << FIRST_SEGMENT_BITS;
+    static const unsigned SEGMENTS_NUM = 64 - FIRST_SEGMENT_BITS;
+
+    std::atomic<ValueT *> _segments[SEGMENTS_NUM];
+    std::atomic<size_t> _size{0};
+    // taken only when a new segment is allocated
+    std::mutex _allocLock;
+
+    static unsigned segmentOf(size_t idx) {
+        // floor(log2(q))
+        const unsigned long long q = (idx >> FIRST_SEGMENT_BITS) + 1;
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(q);
+#else
+        unsigned k = 0;
+        while (q >> (k + 1))
+            ++k;
+        return k;
+#endif
+    }
+
+    static size_t segmentStart(unsigned k) {
+        return FIRST_SEGMENT_SIZE * ((1UL << k) - 1);
+    }
+
+    ValueT *getSegment(unsigned k) {
+        ValueT *seg = _segments[k].load(std::memory_order_acquire);
+        if (seg)
+            return seg;
+
+        std::lock_guard<std::mutex> guard(_allocLock);
+        seg = _segments[k].load(std::memory_order_relaxed);
+        if (!seg) {
+            seg = new ValueT[FIRST_SEGMENT_SIZE << k];
+            _segments[k].store(seg, std::memory_order_release);
+        }
+        return seg;
+    }
+
+  public:
+    ConcurrentVector() {
+        for (auto &seg : _segments)
+            seg.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ConcurrentVector(const ConcurrentVector &) = delete;
+    ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+
+    ~ConcurrentVector() {
+        for (auto &seg : _segments)
+            delete[] seg.load(std::memory_order_relaxed);
+    }
+
+    // append the value and return its index
+    size_t push_back(const ValueT &val) {
+        const size_t idx = _size.fetch_add(1, std::memory_order_relaxed);
+        const unsigned k = segmentOf(idx);
+        assert(k < SEGMENTS_NUM);
+        getSegment(k)[idx - segmentStart(k)] = val;
+        return idx;
+    }
+
+    const ValueT &operator[](size_t idx) const {
+        const unsigned k = segmentOf(idx);
+        const ValueT *seg = _segments[k].load(std::memory_order_acquire);
+        assert(seg && "Index out of bounds");
+        return seg[idx - segmentStart(k)];
+    }
+
+    size_t size() const { return _size.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_CONCURRENT_VECTOR_H_
@@ -0,0 +1,195 @@
+#ifndef DG_ADT_INTERNED_SETS_H_
+#define DG_ADT_INTERNED_SETS_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace dg {
+namespace ADT {
+
+///
+// Hash-consed immutable sets of elements (e.g., IDs). Every set
+// of elements is stored only once and is identified by the pointer
+// to its representation, so equal sets share the memory and can be
+// compared by the pointer. The results of adding an element to a set
+// and of union of two sets are memoized. The empty set is nullptr.
+// The sets are freed together with this object.
+template <typename ElemT>
+class InternedSets {
+  public:
+    class Set {
+        friend class InternedSets;
+
+        // sorted elements
+        std::vector<ElemT> _elems;
+
+        Set(std::vector<ElemT> &&elems) : _elems(std::move(elems)) {}
+
+      public:
+        using const_iterator = typename std::vector<ElemT>::const_iterator;
+
+        const_iterator begin() const { return _elems.begin(); }
+        const_iterator end() const { return _elems.end(); }
+        size_t size() const { return _elems.size(); }
+
+        bool contains(const ElemT &e) const {
+            return std::binary_search(_elems.begin(), _elems.end(), e);
+        }
+    };
+
+  private:
+    // the sets by the hash of their elements
+    std::map<size_t, std::vector<std::unique_ptr<Set>>> _sets;
+    // memoized results of operations
+    std::map<std::pair<const Set *, const Set *>, const Set *> _unions;
+    std::map<std::pair<const Set *, ElemT>, const Set *> _inserts;
+    size_t _setsNum{0};
+
+    mutable std::mutex _lock;
+    bool _concurrent{false};
+
+    static size_t hash(const std::vector<ElemT> &elems) {
+        size_t h = elems.size();
+        for (const auto &e : elems)
+            h ^= std::hash<ElemT>()(e) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    // the elements must be sorted and unique
+    const Set *_get(std::vector<ElemT> &&elems) {
+        if (elems.empty())
+            return nullptr;
+
+        auto &bucket = _sets[hash(elems)];
+        for (const auto &S : bucket) {
+            if (S->_elems == elems)
+                return S.get();
+        }
+
+        bucket.emplace_back(new Set(std::move(elems)));
+        ++_setsNum;
+        return bucket.back().get();
+    }
+
+    const Set *_insert(const Set *S, const ElemT &e) {
+        if (S && S->contains(e))
+            return S;
+
+        auto it = _inserts.find({S, e});
+        if (it != _inserts.end())
+            return it->second;
+
+        std::vector<ElemT> elems;
+        if (S) {
+            elems.reserve(S->size() + 1);
+            elems = S->_elems;
+        }
+        elems.insert(std::upper_bound(elems.begin(), elems.end(), e), e);
+
+        const Set *ret = _get(std::move(elems));
+        _inserts.emplace(std::make_pair(S, e), ret);
+        return ret;
+    }
+
+    const Set *_union(const Set *A, const Set *B) {
+        if (!A || A == B)
+            return B;
+        if (!B)
+            return A;
+
+        // the union is commutative
+        if (B < A)
+            std::swap(A, B);
+
+        auto it = _unions.find({A, B});
+        if (it != _unions.end())
+            return it->second;
+
+        std::vector<ElemT> elems;
+        elems.reserve(std::max(A->size(), B->size()));
+        std::set_union(A->begin(), A->end(), B->begin(), B->end(),
+                       std::back_inserter(elems));
+
+        // the result is often one of the sets, do not search for it
+        const Set *ret;
+        if (elems.size() == A->size())
+            ret = A;
+        else if (elems.size() == B->size())
+            ret = B;
+        else
+            ret = _get(std::move(elems));
+
+        _unions.emplace(std::make_pair(A, B), ret);
+        return ret;
+    }
+
+    template <typename FunT>
+    auto locked(const FunT &F) const -> decltype(F()) {
+        if (!_concurrent)
+            return F();
+
+        std::lock_guard<std::mutex> guard(_lock);
+        return F();
+    }
+
+  public:
+    InternedSets() = default;
+    InternedSets(const InternedSets &) = delete;
+    InternedSets &operator=(const InternedSets &) = delete;
+
+    // Use locking so that the sets can be created from multiple threads
+    void setConcurrent(bool b) { _concurrent = b; }
+
+    // get the set with the given elements (in any order)
+    const Set *get(std::vector<ElemT> elems) {
+        std::sort(elems.begin(), elems.end());
+        elems.erase(std::unique(elems.begin(), elems.end()), elems.end());
+        return locked([&]() { return _get(std::move(elems)); });
+    }
+
+    // get the set S \cup {e}
+    const Set *insert(const Set *S, const ElemT &e) {
+        return locked([&]() { return _insert(S, e); });
+    }
+
+    // get the set A \cup B
+    const Set *getUnion(const Set *A, const Set *B) {
+        return locked([&]() { return _union(A, B); });
+    }
+
+    // get the set of elements of S for which P holds
+    template <typename PredT>
+    const Set *filter(const Set *S, const PredT &P) {
+        if (!S)
+            return nullptr;
+
+        std::vector<ElemT> elems;
+        elems.reserve(S->size());
+        for (const auto &e : *S) {
+            if (P(e))
+                elems.push_back(e);
+        }
+
+        if (elems.size() == S->size())
+            return S;
+        return locked([&]() { return _get(std::move(elems)); });
+    }
+
+    // the number of different non-empty sets
+    size_t size() const {
+        return locked([this]() { return _setsNum; });
+    }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // DG_ADT_INTERNED_SETS_H_
@@ -3,36 +3,44 @@
 
 #include "Bits.h"
 #include "Bitvector.h"
+#include "ChunkedBitvector.h"
 
 namespace dg {
 namespace ADT {
 
-// this is just a wrapper around sparse bitvector
+// this is just a wrapper around a bitvector
 // that translates the bitvector methods to a new methods.
 // There is no possibility to remove elements from the set.
-class BitvectorNumberSet {
+template <typename ContainerT>
+class BitvectorNumberSetImpl {
     using NumT = uint64_t;
-    using ContainerT = SparseBitvectorImpl<uint64_t, NumT>;
 
     ContainerT _bitvector;
 
   public:
     using const_iterator = typename ContainerT::const_iterator;
 
-    BitvectorNumberSet() = default;
-    BitvectorNumberSet(size_t n) : _bitvector(n){};
-    BitvectorNumberSet(BitvectorNumberSet &&) = default;
+    BitvectorNumberSetImpl() = default;
+    BitvectorNumberSetImpl(size_t n) : _bitvector(n){};
+    BitvectorNumberSetImpl(BitvectorNumberSetImpl &&) = default;
 
     bool add(NumT n) { return !_bitvector.set(n); }
     bool has(NumT n) const { return _bitvector.get(n); }
     bool empty() const { return _bitvector.empty(); }
     size_t size() const { return _bitvector.size(); }
-    void swap(BitvectorNumberSet &oth) { oth._bitvector.swap(_bitvector); }
+    void swap(BitvectorNumberSetImpl &oth) {
+        oth._bitvector.swap(_bitvector);
+    }
 
     const_iterator begin() const { return _bitvector.begin(); }
     const_iterator end() const { return _bitvector.end(); }
 };
 
+using BitvectorNumberSet =
+        BitvectorNumberSetImpl<SparseBitvectorImpl<uint64_t, uint64_t>>;
+// better for dense numbers
+using ChunkedBitvectorNumberSet = BitvectorNumberSetImpl<ChunkedBitvector>;
+
 // This class is a container for a set of numbers
 // that is optimized for holding small values
 // (values less than sizeof(NumT)*8*SmallElemNum)).
@@ -1,6 +1,7 @@
 #ifndef DG_GENERIC_CALLGRAPH_H_
 #define DG_GENERIC_CALLGRAPH_H_
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -44,6 +45,22 @@ class GenericCallGraph {
             return true;
         }
 
+        void removeCalls() {
+            for (FuncNode *x : _calls) {
+                auto &C = x->_callers;
+                C.erase(std::remove(C.begin(), C.end(), this), C.end());
+            }
+            _calls.clear();
+        }
+
+        void removeCallers() {
+            for (FuncNode *x : _callers) {
+                auto &C = x->_calls;
+                C.erase(std::remove(C.begin(), C.end(), this), C.end());
+            }
+            _callers.clear();
+        }
+
         const std::vector<FuncNode *> &getCalls() const { return _calls; }
         // alias for getCalls()
         const std::vector<FuncNode *> &successors() const { return getCalls(); }
@@ -78,6 +95,23 @@ class GenericCallGraph {
         return A->addCall(B);
     }
 
+    // remove the calls made by the value
+    void removeCalls(const ValueT &v) {
+        if (auto *A = get(v))
+            A->removeCalls();
+    }
+
+    // remove the value with the calls from and to it
+    void remove(const ValueT &v) {
+        auto it = _mapping.find(v);
+        if (it == _mapping.end())
+            return;
+
+        it->second.removeCalls();
+        it->second.removeCallers();
+        _mapping.erase(it);
+    }
+
     const FuncNode *get(const ValueT &v) const {
         auto it = _mapping.find(v);
         if (it == _mapping.end()) {
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdarg>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -12,6 +13,7 @@
 #endif // not NDEBUG
 
 #include "dg/PointerAnalysis/Pointer.h"
+#include "dg/PointerAnalysis/PointsToDelta.h"
 #include "dg/PointerAnalysis/PointsToSet.h"
 #include "dg/SubgraphNode.h"
 
@@ -139,6 +141,23 @@ class PSNode : public SubgraphNode<PSNode> {
 
     unsigned int dfsid = 0;
 
+    // changes of the points-to set, tracked only when
+    // the analysis runs with difference propagation
+    std::unique_ptr<PointsToDelta> _delta;
+
+    // pointers added to the node while it is processed in parallel
+    // with other nodes. Other nodes may read the points-to set
+    // at the same time, so the pointers are moved to the points-to set
+    // only after all the nodes are processed.
+    std::unique_ptr<PointsToSetT> _pending;
+
+    bool addPending(const Pointer &ptr) {
+        // the same as if we added the pointer to the points-to set
+        if (pointsTo.has(ptr) || pointsTo.has({ptr.target, Offset::UNKNOWN}))
+            return false;
+        return _pending->add(ptr);
+    }
+
   public:
     ///
     // Construct a PSNode
@@ -232,15 +251,39 @@ class PSNode : public SubgraphNode<PSNode> {
     PointsToSetT pointsTo;
 
     // convenient helper
-    bool addPointsTo(PSNode *n, Offset o) {
-        return pointsTo.add(Pointer(n, o));
+    bool addPointsTo(PSNode *n, Offset o) { return addPointsTo(Pointer(n, o)); }
+    bool addPointsTo(const Pointer &ptr) {
+        if (_pending)
+            return addPending(ptr);
+        if (!pointsTo.add(ptr))
+            return false;
+        if (_delta)
+            _delta->add(ptr);
+        return true;
+    }
+    bool addPointsTo(const PointsToSetT &ptrs) {
+        if (_pending) {
+            bool changed = false;
+            for (const auto &ptr : ptrs)
+                changed |= addPending(ptr);
+            return changed;
+        }
+        if (!pointsTo.add(ptrs))
+            return false;
+        if (_delta)
+            _delta->add(ptrs);
+        return true;
     }
-    bool addPointsTo(const Pointer &ptr) { return pointsTo.add(ptr); }
-    bool addPointsTo(const PointsToSetT &ptrs) { return pointsTo.add(ptrs); }
     bool addPointsTo(std::initializer_list<Pointer> ptrs) {
-        return pointsTo.add(ptrs);
+        bool changed = false;
+        for (const auto &ptr : ptrs)
+            changed |= addPointsTo(ptr);
+        return changed;
     }
 
+    PointsToDelta *getDelta() { return _delta.get(); }
+    const PointsToDelta *getDelta() const { return _delta.get(); }
+
     bool doesPointsTo(const Pointer &p) const { return pointsTo.count(p) == 1; }
 
     bool doesPointsTo(PSNode *n, Offset o = 0) const {
@@ -451,6 +494,17 @@ class PSNodeEntry : public PSNode {
         callers.push_back(n);
         return true;
     }
+
+    bool removeCaller(PSNode *n) {
+        for (auto it = callers.begin(), et = callers.end(); it != et; ++it) {
+            if (*it == n) {
+                callers.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
 };
 
 class PSNodeCall : public PSNode {
@@ -490,6 +544,17 @@ class PSNodeCall : public PSNode {
         return true;
     }
 
+    bool removeCallee(PointerSubgraph *ps) {
+        for (auto it = callees.begin(), et = callees.end(); it != et; ++it) {
+            if (*it == ps) {
+                callees.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
 #ifndef NDEBUG
     // verbose dump
     void dumpv() const override {
@@ -548,6 +613,19 @@ class PSNodeCallRet : public PSNode {
         return true;
     }
 
+    bool removeReturn(PSNode *p) {
+        for (auto it = returns.begin(), et = returns.end(); it != et; ++it) {
+            if (*it == p) {
+                returns.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void clearReturns() { returns.clear(); }
+
 #ifndef NDEBUG
     // verbose dump
     void dumpv() const override {
@@ -593,6 +671,17 @@ class PSNodeRet : public PSNode {
         return true;
     }
 
+    bool removeReturnSite(PSNode *r) {
+        for (auto it = returns.begin(), et = returns.end(); it != et; ++it) {
+            if (*it == r) {
+                returns.erase(it);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
 #ifndef NDEBUG
     // verbose dump
     void dumpv() const override {
@@ -2,6 +2,7 @@
 #define DG_POINTER_ANALYSIS_H_
 
 #include <cassert>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointerAnalysisOptions.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
+#include "dg/PointerAnalysis/WaveScheduler.h"
 
 namespace dg {
 namespace pta {
@@ -26,8 +28,17 @@ class PointerAnalysis {
     // the pointer state subgraph
     PointerGraph *PG{nullptr};
 
+    // the number of the current iteration of the analysis
+    // (used to track changes with difference propagation)
+    unsigned _iteration{0};
+    // the number of iterations that the last run() took to reach fixpoint
+    size_t _fixpointIterations{0};
+
     const PointerAnalysisOptions options{};
 
+    // orders the nodes with PointerAnalysisOptions::Scheduler::WAVE
+    std::unique_ptr<WaveScheduler> _waveScheduler;
+
   public:
     PointerAnalysis(PointerGraph *ps, PointerAnalysisOptions opts)
             : PG(ps), options(std::move(opts)) {
@@ -64,6 +75,15 @@ class PointerAnalysis {
     PointerGraph *getPG() { return PG; }
     const PointerGraph *getPG() const { return PG; }
 
+    size_t getIterationsNum() const { return _fixpointIterations; }
+
+    // the graph was changed outside of the analysis
+    // (e.g., some functions were built again)
+    void graphChanged() {
+        if (_waveScheduler)
+            _waveScheduler->invalidate();
+    }
+
     virtual void enqueue(PSNode *n) { changed.push_back(n); }
 
     virtual void preprocess() {}
@@ -73,8 +93,14 @@ class PointerAnalysis {
 
         PSNode *root = PG->getEntry()->getRoot();
         assert(root && "Do not have root of PG");
-        // rely on C++11 move semantics
-        to_process = PG->getNodes(root);
+        if (_waveScheduler) {
+            to_process = _waveScheduler->getNodes({root});
+        } else {
+            // rely on C++11 move semantics
+            to_process = PG->getNodes(root);
+        }
+
+        filterNodes(to_process);
     }
 
     void queue_globals() {
@@ -86,6 +112,10 @@ class PointerAnalysis {
 
     bool iteration() {
         assert(changed.empty());
+        ++_iteration;
+
+        if (options.solverThreads > 1)
+            return parallelIteration();
 
         for (PSNode *cur : to_process) {
             bool enq = false;
@@ -106,14 +136,8 @@ class PointerAnalysis {
 
         if (!changed.empty()) {
             // DONT std::move - it prevents compiler from copy ellision
-            to_process = PG->getNodes(changed /* starting set */,
-                                      true /* interprocedural */,
-                                      last_processed_num /* expected num */);
-
-            // since changed was not empty,
-            // the to_process must not be empty too
-            assert(!to_process.empty());
-            assert(to_process.size() >= changed.size());
+            to_process = getNodesToProcess(changed, last_processed_num);
+            filterNodes(to_process);
             changed.clear();
         }
     }
@@ -158,10 +182,65 @@ class PointerAnalysis {
     // we do not need to pass this to the LLVM part...
     virtual bool handleJoin(PSNode * /*unused*/) { return false; }
 
+  protected:
+    // Can the node be processed in parallel with other nodes?
+    // Such a node may change only its own points-to set
+    // (which is done via PSNode::addPointsTo) and must not change
+    // anything else (the graph, memory objects, ...).
+    virtual bool canProcessInParallel(PSNode * /*unused*/) const {
+        return false;
+    }
+
+    // called before some nodes are processed in parallel,
+    // the analysis must prepare everything that the nodes
+    // would create lazily (e.g., memory objects)
+    virtual void prepareParallelIteration() {}
+
+    // remove the nodes that should not be processed from the queue
+    // (the demand-driven analysis processes only some of the nodes)
+    virtual void filterNodes(std::vector<PSNode *> & /*nodes*/) {}
+
+    // get the nodes that must be processed in the next iteration
+    // given the nodes that changed in the last iteration
+    virtual std::vector<PSNode *>
+    getNodesToProcess(const std::vector<PSNode *> &changedNodes,
+                      size_t lastProcessedNum) {
+        std::vector<PSNode *> nodes;
+        if (_waveScheduler) {
+            nodes = _waveScheduler->getNodes(changedNodes, lastProcessedNum);
+        } else {
+            nodes = PG->getNodes(changedNodes /* starting set */,
+                                 true /* interprocedural */, lastProcessedNum);
+        }
+
+        // since changed was not empty,
+        // the to_process must not be empty too
+        assert(!nodes.empty());
+        assert(nodes.size() >= changedNodes.size());
+        return nodes;
+    }
+
+    // process the globals and then the nodes of the graph
+    // until the fixpoint is reached, return false if the analysis
+    // was terminated because of PointerAnalysisOptions::maxIterations
+    bool fixpoint();
+
   private:
     // check the sanity of results of pointer analysis
     void sanityCheck();
 
+    // start/stop tracking changes of points-to sets
+    // for difference propagation
+    void initDeltas();
+    void releaseDeltas();
+
+    // process the nodes from to_process using multiple threads
+    // (see PointerAnalysisOptions::solverThreads)
+    bool parallelIteration();
+    // process the nodes that do not depend on each other
+    // using multiple threads
+    void processInParallel(const std::vector<PSNode *> &nodes);
+
     bool processNode(PSNode * /*node*/);
     bool processLoad(PSNode *node);
     bool processGep(PSNode *node);
@@ -0,0 +1,83 @@
+#ifndef DG_ANALYSIS_POINTS_TO_DEMAND_DRIVEN_H_
+#define DG_ANALYSIS_POINTS_TO_DEMAND_DRIVEN_H_
+
+#include <cassert>
+#include <unordered_set>
+#include <vector>
+
+#include "PointerAnalysisFI.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Demand-driven flow-insensitive pointer analysis.
+// The analysis does nothing in run(), the points-to sets are computed
+// on queries (see query()). A query marks the node as relevant together
+// with all the nodes that its points-to set depends on (its operands,
+// transitively) and runs the flow-insensitive analysis only on
+// the relevant nodes. If a relevant node reads memory, the stores
+// that may write the read memory are added (with their operands)
+// until nothing new is relevant. The addresses written by the stores
+// are computed only if they are not copied from allocations. The analysis is run until a pass over all relevant nodes
+// changes nothing, so the points-to sets of relevant nodes are final
+// and the answered queries are not computed again.
+// The results include the results of PointerAnalysisFI, which does
+// not process again the nodes that precede a changed node
+// (unless they are on a loop with the node).
+class PointerAnalysisDemand : public PointerAnalysisFI {
+    // the relevant nodes (indexed by IDs of nodes)
+    std::vector<bool> _relevant;
+    std::vector<PSNode *> _relevantNodes;
+    // some relevant node reads memory,
+    // so we need to know where the stores write
+    bool _readsMemory{false};
+    bool _preprocessed{false};
+
+    bool isRelevant(const PSNode *n) const {
+        return n->getID() < _relevant.size() && _relevant[n->getID()];
+    }
+
+    // mark the node and its operands (transitively) as relevant,
+    // return true if some node was not relevant before
+    bool addRelevant(PSNode *n);
+    // add the operands that the relevant nodes got
+    // when the graph changed during the analysis
+    bool addNewOperands();
+    // make relevant the stores that may write to the memory
+    // that the relevant nodes read
+    bool addRelevantWrites();
+    void collectReadMemory(std::unordered_set<MemoryObject *> &memory);
+    bool mayWrite(PSNode *n, const std::unordered_set<MemoryObject *> &memory);
+
+  public:
+    PointerAnalysisDemand(PointerGraph *ps) : PointerAnalysisDemand(ps, {}) {}
+
+    PointerAnalysisDemand(PointerGraph *ps, PointerAnalysisOptions opts)
+            : PointerAnalysisFI(ps, opts.setCollapseCycles(false)
+                                            .setDiffPropagation(false)) {}
+
+    void preprocess() override {
+        // the analysis runs for every query
+        if (_preprocessed)
+            return;
+        PointerAnalysisFI::preprocess();
+        _preprocessed = true;
+    }
+
+    // compute the points-to set of the node,
+    // return false if the analysis did not reach the fixpoint
+    // (see PointerAnalysisOptions::maxIterations)
+    bool query(PSNode *n);
+
+    // the number of nodes that the analysis processed so far
+    size_t getRelevantNodesNum() const { return _relevantNodes.size(); }
+
+  protected:
+    void filterNodes(std::vector<PSNode *> &nodes) override;
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif // DG_ANALYSIS_POINTS_TO_DEMAND_DRIVEN_H_
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "PointerAnalysis.h"
@@ -16,6 +17,22 @@ namespace pta {
 class PointerAnalysisFI : public PointerAnalysis {
     std::vector<std::unique_ptr<MemoryObject>> memory_objects;
 
+    // nodes from collapsed copy cycles mapped to the representatives
+    // of the cycles (see PointerAnalysisOptions::collapseCycles)
+    std::unordered_map<PSNode *, PSNode *> collapsed;
+    // the number of operands that PHI nodes had when we searched
+    // for the copy cycles going through them
+    std::unordered_map<PSNode *, size_t> searched;
+
+    // the number of nodes of the graph when we created memory objects
+    // for the parallel iteration
+    size_t preparedNodesNum{0};
+
+    // find copy cycles reachable from the given nodes and collapse them,
+    // return the representatives of the collapsed cycles
+    std::vector<PSNode *> collapseCycles(const std::vector<PSNode *> &from);
+    PSNode *collapseCycle(const std::vector<PSNode *> &cycle);
+
     void preprocessGEPs() {
         // if a node is in a loop (a scc that has more than one node),
         // then every GEP that is also stored to the same memory afterwards
@@ -46,8 +63,18 @@ class PointerAnalysisFI : public PointerAnalysis {
     void preprocess() override {
         if (options.preprocessGeps)
             preprocessGEPs();
+        if (options.collapseCycles)
+            collapseCycles(PG->getNodes(PG->getEntry()->getRoot()));
     }
 
+    bool beforeProcessed(PSNode *n) override;
+    bool afterProcessed(PSNode *n) override;
+
+    bool canProcessInParallel(PSNode *n) const override;
+    void prepareParallelIteration() override;
+
+    size_t getCollapsedNodesNum() const { return collapsed.size(); }
+
     void getMemoryObjects(PSNode *where, const Pointer &pointer,
                           std::vector<MemoryObject *> &objects) override {
         // irrelevant in flow-insensitive
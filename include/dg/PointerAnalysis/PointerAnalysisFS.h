@@ -6,6 +6,7 @@
 
 #include "MemoryObject.h"
 #include "PointerGraph.h"
+#include "dg/util/cow_shared_ptr.h"
 
 namespace dg {
 namespace pta {
@@ -16,7 +17,10 @@ namespace pta {
 class PointerAnalysisFS : public PointerAnalysis {
   public:
     // using MemoryObjectsSetT = std::set<MemoryObject *>;
-    using MemoryMapT = std::map<PSNode *, std::unique_ptr<MemoryObject>>;
+    // The memory objects are shared between the memory maps
+    // and copied only when a node writes to them
+    using MemoryObjectPtr = cow_shared_ptr<MemoryObject>;
+    using MemoryMapT = std::map<PSNode *, MemoryObjectPtr>;
 
     // this is an easy but not very efficient implementation,
     // works for testing
@@ -26,6 +30,11 @@ class PointerAnalysisFS : public PointerAnalysis {
                "Preprocessing GEPs does not work correctly for FS analysis");
         memoryMaps.reserve(ps->size() / 5);
         ps->computeLoops();
+
+        // the nodes take the memory maps from their predecessors,
+        // so the order of nodes must follow the control flow
+        if (options.scheduler == PointerAnalysisOptions::Scheduler::WAVE)
+            _waveScheduler.reset(new WaveScheduler(ps, true));
     }
 
     PointerAnalysisFS(PointerGraph *ps) : PointerAnalysisFS(ps, {}) {}
@@ -125,17 +134,21 @@ class PointerAnalysisFS : public PointerAnalysis {
         MemoryMapT *mm = where->getData<MemoryMapT>();
         assert(mm && "Node does not have memory map");
 
+        const bool write = canChangeMM(where);
         auto I = mm->find(pointer.target);
         if (I != mm->end()) {
-            objects.push_back(I->second.get());
+            // the node that writes to the object gets its own copy
+            // of the object, the other nodes only read it
+            objects.push_back(write ? I->second.getWritable()
+                                    : sharedObject(I->second));
         }
 
         // if we haven't found any memory object, but this psnode
         // is a write to memory, create a new one, so that
         // the write has something to write to
-        if (objects.empty() && canChangeMM(where)) {
+        if (objects.empty() && write) {
             MemoryObject *mo = new MemoryObject(pointer.target);
-            mm->emplace(pointer.target, std::unique_ptr<MemoryObject>(mo));
+            (*mm)[pointer.target].reset(mo);
             objects.push_back(mo);
         }
     }
@@ -165,15 +178,59 @@ class PointerAnalysisFS : public PointerAnalysis {
         return false;
     }
 
-    static bool mergeObjects(PSNode *node, MemoryObject *to, MemoryObject *from,
+    // the object for reading, it must not be modified
+    static MemoryObject *sharedObject(const MemoryObjectPtr &mo) {
+        return const_cast<MemoryObject *>(mo.get());
+    }
+
+    static bool overwrites(PSNode *node, const MemoryObject *from,
+                           PointsToSetT *overwritten) {
+        if (!overwritten)
+            return false;
+
+        for (const auto &fromIt : from->pointsTo) {
+            if (overwritten->count(Pointer(node, fromIt.first)))
+                return true;
+        }
+        return false;
+    }
+
+    static bool includes(const MemoryObject *mo, const Offset &off,
+                         const PointsToSetT &S) {
+        auto it = mo->find(off);
+        if (it == mo->end())
+            return S.empty();
+
+        for (const auto &ptr : S) {
+            if (!it->second.has(ptr))
+                return false;
+        }
+        return true;
+    }
+
+    // does 'mo' contain all the pointers from 'rhs'?
+    static bool includes(const MemoryObject *mo, const MemoryObject *rhs) {
+        for (const auto &it : rhs->pointsTo) {
+            if (!includes(mo, it.first, it.second))
+                return false;
+        }
+        return true;
+    }
+
+    // copy the object only if there is something new to add
+    static bool mergeObjects(PSNode *node, MemoryObjectPtr &to,
+                             const MemoryObject *from,
                              PointsToSetT *overwritten) {
         bool changed = false;
 
-        for (auto &fromIt : from->pointsTo) {
+        for (const auto &fromIt : from->pointsTo) {
             if (overwritten && overwritten->count(Pointer(node, fromIt.first)))
                 continue;
 
-            auto &S = to->pointsTo[fromIt.first];
+            if (includes(to.get(), fromIt.first, fromIt.second))
+                continue;
+
+            auto &S = to.getWritable()->pointsTo[fromIt.first];
             for (const auto &ptr : fromIt.second)
                 changed |= S.add(ptr);
         }
@@ -188,11 +245,26 @@ class PointerAnalysisFS : public PointerAnalysis {
         bool changed = false;
         for (auto &it : *from) {
             PSNode *fromTarget = it.first;
-            std::unique_ptr<MemoryObject> &toMo = (*mm)[fromTarget];
-            if (toMo == nullptr)
+            MemoryObjectPtr &toMo = (*mm)[fromTarget];
+            // the same object, nothing to merge
+            if (toMo.get() == it.second.get())
+                continue;
+
+            // if the merged object would be the same as the object
+            // from the predecessor, just share it
+            const MemoryObject *fromMo = it.second.get();
+            if (!overwrites(fromTarget, fromMo, overwritten) &&
+                (toMo.get() == nullptr || includes(fromMo, toMo.get()))) {
+                changed |= toMo.get() == nullptr ? !fromMo->pointsTo.empty()
+                                                 : !includes(toMo.get(), fromMo);
+                toMo = it.second;
+                continue;
+            }
+
+            if (toMo.get() == nullptr)
                 toMo.reset(new MemoryObject(fromTarget));
 
-            changed |= mergeObjects(fromTarget, toMo.get(), it.second.get(),
+            changed |= mergeObjects(fromTarget, toMo, it.second.get(),
                                     overwritten);
         }
 
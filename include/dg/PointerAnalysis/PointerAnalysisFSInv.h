@@ -18,13 +18,14 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
         return canInvalidateMM(n) || PointerAnalysisFS::needsMerge(n);
     }
 
+    // get the object for writing
     static MemoryObject *getOrCreateMO(MemoryMapT *mm, PSNode *target) {
-        std::unique_ptr<MemoryObject> &moptr = (*mm)[target];
+        MemoryObjectPtr &moptr = (*mm)[target];
         if (!moptr)
             moptr.reset(new MemoryObject(target));
 
         assert(mm->find(target) != mm->end());
-        return moptr.get();
+        return moptr.getWritable();
     }
 
   public:
@@ -172,7 +173,7 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
             // get or create a memory object for this target
 
             MemoryObject *mo = getOrCreateMO(mm, I.first);
-            MemoryObject *pmo = I.second.get();
+            const MemoryObject *pmo = I.second.get();
 
             for (auto &it : *mo) {
                 // remove pointers to locals from the points-to set
@@ -183,8 +184,8 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
                 }
             }
 
-            for (auto &it : *pmo) {
-                PointsToSetT &predS = it.second;
+            for (const auto &it : *pmo) {
+                const PointsToSetT &predS = it.second;
                 if (predS.empty())
                     continue;
 
@@ -342,7 +343,7 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
 
             // get or create a memory object for this target
             MemoryObject *mo = getOrCreateMO(mm, I.first);
-            MemoryObject *pmo = I.second.get();
+            const MemoryObject *pmo = I.second.get();
 
             // Remove references to invalidated memory from mo
             // if the invalidated object is just one.
@@ -378,8 +379,8 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
 
             // merge pointers from pmo to mo, but skip
             // the pointers that may point to the freed memory
-            for (auto &it : *pmo) {
-                PointsToSetT &predS = it.second;
+            for (const auto &it : *pmo) {
+                const PointsToSetT &predS = it.second;
                 if (predS.empty()) // keep the map clean
                     continue;
 
@@ -419,11 +420,15 @@ class PointerAnalysisFSInv : public PointerAnalysisFS {
         for (auto &it : *mm) {
             auto pmit = pm->find(it.first);
             if (pmit == pm->end()) {
-                for (auto &mit : *it.second) {
+                // keep the shared object if there is nothing to add
+                const MemoryObject *mo = it.second.get();
+                for (const auto &mit : *mo) {
                     if (mit.first.isUnknown())
                         continue; // FIXME: we are optimistic here...
-                    changed |= it.second->addPointsTo(mit.first,
-                                                      Pointer{INVALIDATED, 0});
+                    if (mit.second.has(Pointer{INVALIDATED, 0}))
+                        continue;
+                    changed |= it.second.getWritable()->addPointsTo(
+                            mit.first, Pointer{INVALIDATED, 0});
                 }
                 continue;
             }
@@ -18,6 +18,36 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // INVALIDATED object.
     bool invalidateNodes{false};
 
+    // Propagate only the pointers that were added to points-to sets
+    // of operands since the node was processed the last time
+    // (difference propagation) instead of whole points-to sets.
+    bool diffPropagation{false};
+
+    // Find cycles of copy nodes (PHI, CAST and GEP with zero offset)
+    // and collapse them into a single representative node
+    // (used only by the flow-insensitive analysis).
+    bool collapseCycles{false};
+
+    // Before the analysis, merge the nodes of the graph that must have
+    // the same points-to sets (offline variable substitution,
+    // see PSPointerEquivalenceMerger). Done by the builders of the graph.
+    bool mergeEquivalentNodes{false};
+
+    // How to schedule the nodes that are processed in an iteration
+    // of the analysis.
+    enum class Scheduler {
+        // all nodes reachable from the changed nodes in the BFS order
+        BFS,
+        // the same nodes in the topological order of the constraint graph
+        // condensed to SCCs (wave propagation)
+        WAVE
+    } scheduler{Scheduler::BFS};
+
+    // The number of threads that process the nodes of the graph.
+    // Values greater than 1 make the flow-insensitive analysis process
+    // nodes that change only their own points-to sets in parallel.
+    unsigned solverThreads{1};
+
     PointerAnalysisOptions &setInvalidateNodes(bool b) {
         invalidateNodes = b;
         return *this;
@@ -26,6 +56,26 @@ struct PointerAnalysisOptions : AnalysisOptions {
         preprocessGeps = b;
         return *this;
     }
+    PointerAnalysisOptions &setDiffPropagation(bool b) {
+        diffPropagation = b;
+        return *this;
+    }
+    PointerAnalysisOptions &setCollapseCycles(bool b) {
+        collapseCycles = b;
+        return *this;
+    }
+    PointerAnalysisOptions &setMergeEquivalentNodes(bool b) {
+        mergeEquivalentNodes = b;
+        return *this;
+    }
+    PointerAnalysisOptions &setScheduler(Scheduler s) {
+        scheduler = s;
+        return *this;
+    }
+    PointerAnalysisOptions &setSolverThreads(unsigned n) {
+        solverThreads = n;
+        return *this;
+    }
 
     // Perform maximally this number of iterations.
     // If exceeded, the analysis is terminated and points-to sets
@@ -0,0 +1,131 @@
+#ifndef DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
+#define DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "PointerAnalysisFI.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Staged (sparse) flow-sensitive pointer analysis.
+// First, we run the flow-insensitive analysis. Its results tell us
+// which memory can be written by each node. Then we run the analysis
+// again, flow-sensitively, but instead of keeping a memory map
+// for every node (as PointerAnalysisFS does), we keep the contents
+// of a memory object only where the object may be defined
+// (a write to the object or a join of the control flow) and propagate
+// the contents along the def-use chains of the object
+// (a kind of memory SSA built on demand).
+// The results are comparable with PointerAnalysisFS, only the calls
+// via function pointers are resolved by the flow-insensitive analysis.
+class PointerAnalysisSFS : public PointerAnalysisFI {
+    ///
+    // The contents of a memory object after a node that may define it
+    struct MemoryValue {
+        PSNode *node;
+        MemoryObject object;
+        // is this a write to the object or just a join?
+        bool isDef;
+        // the values of the object that reach the node
+        std::vector<MemoryValue *> inputs;
+        // the values that this value reaches
+        std::vector<MemoryValue *> users;
+        // the nodes that read this value
+        std::set<PSNode *> readers;
+
+        MemoryValue(PSNode *n, PSNode *target, bool def)
+                : node(n), object(target), isDef(def) {}
+    };
+
+    // the sparse (flow-sensitive) stage is running
+    bool _sparse{false};
+    // the memory SSA must be built again (the graph changed)
+    bool _rebuild{false};
+
+    // the memory objects that a node may write according to
+    // the flow-insensitive analysis (indexed by IDs of nodes)
+    std::vector<std::vector<PSNode *>> _writes;
+    std::vector<bool> _global;
+    // the nodes that were processed by the sparse stage
+    std::vector<bool> _processed;
+
+    std::vector<std::unique_ptr<MemoryValue>> _values;
+    // the value of an object after a node (the key are the IDs
+    // of the node and the object), nullptr if no value reaches the node
+    std::unordered_map<uint64_t, MemoryValue *> _valuesAt;
+    // the values of the objects defined at a node
+    std::unordered_map<PSNode *, std::vector<MemoryValue *>> _nodeValues;
+    // created values whose inputs were not searched yet
+    std::vector<MemoryValue *> _unresolved;
+
+    // the nodes that read a memory value that changed
+    // or whose operands changed
+    std::vector<PSNode *> _pendingNodes;
+    std::vector<bool> _pending;
+
+    static uint64_t key(PSNode *n, PSNode *target) {
+        return (static_cast<uint64_t>(n->getID()) << 32) | target->getID();
+    }
+
+    // the node that holds the memory state for 'n'
+    // (the globals write to the initial state of the program)
+    PSNode *memoryNode(PSNode *n) const;
+    bool writes(PSNode *n, PSNode *target) const;
+
+    void computeWrites();
+    void resetPointsTo();
+    void resetMemorySSA();
+
+    // get the value of 'target' after the node 'n'
+    MemoryValue *getValue(PSNode *n, PSNode *target);
+    MemoryValue *createValue(PSNode *n, PSNode *target);
+    void resolveValues();
+
+    bool mergeInputs(MemoryValue *val);
+    bool mergeInput(MemoryValue *val, MemoryValue *input);
+    void propagate(MemoryValue *val);
+    void setPending(PSNode *n);
+
+  public:
+    PointerAnalysisSFS(PointerGraph *ps) : PointerAnalysisSFS(ps, {}) {}
+
+    PointerAnalysisSFS(PointerGraph *ps, PointerAnalysisOptions opts)
+            : PointerAnalysisFI(ps, opts.setPreprocessGeps(false)
+                                            .setCollapseCycles(false)
+                                            .setDiffPropagation(false)) {
+        ps->computeLoops();
+    }
+
+    // runs the flow-insensitive stage
+    void preprocess() override;
+
+    bool afterProcessed(PSNode *n) override;
+    void enqueue(PSNode *n) override;
+
+    bool functionPointerCall(PSNode *where, PSNode *what) override;
+
+    void getMemoryObjects(PSNode *where, const Pointer &pointer,
+                          std::vector<MemoryObject *> &objects) override;
+
+    // the number of memory values created by the sparse stage
+    size_t getMemoryValuesNum() const { return _values.size(); }
+
+  protected:
+    bool canProcessInParallel(PSNode *n) const override;
+
+    std::vector<PSNode *>
+    getNodesToProcess(const std::vector<PSNode *> &changedNodes,
+                      size_t lastProcessedNum) override;
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif // DG_ANALYSIS_POINTS_TO_SPARSE_FLOW_SENSITIVE_H_
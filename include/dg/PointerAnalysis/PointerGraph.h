@@ -115,6 +115,9 @@ class PointerGraph {
     GenericCallGraph<PSNode *> callGraph;
     GlobalNodesT _globals;
 
+    // assigns IDs to the pointers in the points-to sets of this graph
+    PointerIDLookupTable _lookupTable;
+
     // check for correct count of variadic arguments
     template <PSNodeType type, size_t actual_size>
     constexpr static ssize_t expected_args_size() {
@@ -185,6 +188,7 @@ class PointerGraph {
 
     template <PSNodeType Type, typename... Args>
     PSNode *create(Args &&...args) {
+        PointerIDLookupTable::Binding bind(_lookupTable);
         PSNode *n = nodeFactory<Type>(std::forward<Args>(args)...);
         nodes.emplace_back(n); // C++17 returns a referece
         assert(n->getID() == nodes.size() - 1);
@@ -209,6 +213,9 @@ class PointerGraph {
     const GenericCallGraph<PSNode *> &getCallGraph() const { return callGraph; }
     const SubgraphsT &getSubgraphs() const { return _subgraphs; }
 
+    PointerIDLookupTable &getLookupTable() { return _lookupTable; }
+    const PointerIDLookupTable &getLookupTable() const { return _lookupTable; }
+
     const NodesT &getNodes() const { return nodes; }
     const GlobalNodesT &getGlobals() const { return _globals; }
     size_t size() const { return nodes.size() + _globals.size(); }
@@ -224,6 +231,8 @@ class PointerGraph {
     void setEntry(PointerSubgraph *e);
 
     void remove(PSNode *nd);
+    // remove the subgraph, its nodes must have been removed already
+    void remove(PointerSubgraph *subg);
 
     // get nodes in BFS order and store them into
     // the container
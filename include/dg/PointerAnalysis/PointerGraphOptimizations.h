@@ -1,6 +1,9 @@
 #ifndef DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 #define DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 
+#include <unordered_set>
+#include <vector>
+
 #include "PointsToMapping.h"
 
 namespace dg {
@@ -73,6 +76,55 @@ class PSEquivalentNodesMerger {
     unsigned merged_nodes_num;
 };
 
+///
+// Offline variable substitution (hash-based value numbering):
+// the nodes get numbers such that the nodes with the same number must
+// have the same points-to sets and all but the first such node are
+// removed. The nodes are numbered in the topological order of
+// the constraint graph (edges go from operands to users), the nodes
+// on its cycles get unique numbers (see the collapseCycles option).
+// Two loads of the same pointer get the same number only if they read
+// the same state of memory, i.e., there is no write or join of control
+// flow between them. This holds for both the flow-sensitive
+// and the flow-insensitive analysis (which processes the nodes
+// in the order of the control flow too).
+class PSPointerEquivalenceMerger {
+  public:
+    using MappingT = PointsToMapping<PSNode *>;
+
+    PSPointerEquivalenceMerger(PointerGraph *g) : G(g) {}
+
+    // the node may change after the merging (e.g., it gets new operands
+    // when the graph is extended during the analysis), so it keeps
+    // its own number and it is never removed
+    void setOpaque(PSNode *n) { opaque.insert(n); }
+
+    MappingT &getMapping() { return mapping; }
+    const MappingT &getMapping() const { return mapping; }
+
+    unsigned getNumOfMergedNodes() const { return merged_nodes_num; }
+
+    unsigned run();
+
+  private:
+    unsigned newNumber() { return ++last_number; }
+    unsigned getNumber(PSNode *n);
+    // the number of the state of memory that the node reads
+    unsigned getMemoryVersion(PSNode *n);
+
+    PointerGraph *G;
+    std::unordered_set<PSNode *> opaque;
+    // the value numbers of nodes (indexed by IDs of nodes)
+    std::vector<unsigned> numbers;
+    // the numbers of states of memory (indexed by IDs of nodes)
+    std::vector<unsigned> memory_versions;
+    unsigned last_number{0};
+    // map nodes to its equivalent representant
+    MappingT mapping;
+
+    unsigned merged_nodes_num{0};
+};
+
 class PointerGraphOptimizer {
     using MappingT = PointsToMapping<PSNode *>;
 
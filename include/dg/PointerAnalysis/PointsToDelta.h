@@ -0,0 +1,107 @@
+#ifndef DG_POINTS_TO_DELTA_H_
+#define DG_POINTS_TO_DELTA_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include "dg/PointerAnalysis/Pointer.h"
+#include "dg/PointerAnalysis/PointsToSet.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Pointers that were added to the points-to set of a node during
+// the previous and the current iteration of the pointer analysis.
+// This is used for difference propagation
+// (see PointerAnalysisOptions::diffPropagation): a node that was processed
+// in the previous iteration needs to propagate only these pointers
+// from its operands instead of their whole points-to sets.
+class PointsToDelta {
+    // the iteration of the analysis, owned by the analysis
+    const unsigned *_iteration;
+    // the iteration in which we started tracking the changes
+    unsigned _since;
+    // the iteration to which belong the pointers in _current
+    unsigned _currentIteration;
+    // the iteration in which the node was processed for the last time
+    // (0 means never)
+    unsigned _lastProcessed{0};
+    // the number of operands the node had when it was processed last time
+    size_t _operandsNum{0};
+
+    PointsToSetT _previous;
+    PointsToSetT _current;
+
+    // move the pointers to the right iteration
+    void _sync() {
+        if (_currentIteration == *_iteration)
+            return;
+
+        if (_currentIteration + 1 == *_iteration) {
+            _previous.swap(_current);
+        } else {
+            _previous.clear();
+        }
+        _current.clear();
+        _currentIteration = *_iteration;
+    }
+
+  public:
+    PointsToDelta(const unsigned *iteration)
+            : _iteration(iteration), _since(*iteration),
+              _currentIteration(*iteration) {}
+
+    void add(const Pointer &ptr) {
+        _sync();
+        _current.add(ptr);
+    }
+
+    void add(const PointsToSetT &S) {
+        _sync();
+        _current.add(S);
+    }
+
+    // pointers added in the previous iteration
+    const PointsToSetT &previous() {
+        _sync();
+        return _previous;
+    }
+
+    // pointers added (so far) in this iteration
+    const PointsToSetT &current() {
+        _sync();
+        return _current;
+    }
+
+    unsigned since() const { return _since; }
+    unsigned lastProcessed() const { return _lastProcessed; }
+    size_t operandsNum() const { return _operandsNum; }
+
+    void setProcessed(size_t operandsNum) {
+        _lastProcessed = *_iteration;
+        _operandsNum = operandsNum;
+    }
+
+    // the operands of the node changed, next time the node
+    // must take the whole points-to sets of operands
+    void setUnprocessed() {
+        _lastProcessed = 0;
+        _operandsNum = 0;
+    }
+
+    // Can a node with the delta 'userDelta' (that uses our node
+    // as its 'idx'-th operand) propagate only the pointers from this delta?
+    // That is possible if the user was processed in the previous iteration
+    // and we tracked all the changes since then.
+    bool coversChangesFor(const PointsToDelta &userDelta, size_t idx) const {
+        return idx < userDelta._operandsNum && userDelta._lastProcessed > 0 &&
+               userDelta._lastProcessed + 1 == *_iteration &&
+               _since < userDelta._lastProcessed;
+    }
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif
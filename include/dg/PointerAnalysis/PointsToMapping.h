@@ -57,12 +57,20 @@ class PointsToMapping {
     // leads to (ValT -> PSNode *).
     void compose(PointsToMapping<PSNode *> &&rhs) {
         for (auto &it : mapping) {
-            if (PSNode *rhs_node = rhs.get(it.second)) {
-                it.second = rhs_node;
-            }
+            it.second = rhs.getFinal(it.second);
         }
     }
 
+    // follow the mapping of a node until we get a node that
+    // is not mapped (the node that a node is mapped to
+    // may have been removed later too)
+    // (makes sense only for ValT = PSNode *)
+    PSNode *getFinal(ValT nd) const {
+        while (PSNode *mapped = get(nd))
+            nd = mapped;
+        return nd;
+    }
+
     iterator begin() { return mapping.begin(); }
     iterator end() { return mapping.end(); }
     const_iterator begin() const { return mapping.begin(); }
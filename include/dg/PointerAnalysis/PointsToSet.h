@@ -3,16 +3,26 @@
 
 #include "dg/PointerAnalysis/PointsToSets/AlignedPointerIdPointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/AlignedSmallOffsetsPointsToSet.h"
+#include "dg/PointerAnalysis/PointsToSets/BDDPointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/OffsetsSetPointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/PointerIdPointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/SeparateOffsetsPointsToSet.h"
+#include "dg/PointerAnalysis/PointsToSets/SharedPointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/SimplePointsToSet.h"
 #include "dg/PointerAnalysis/PointsToSets/SmallOffsetsPointsToSet.h"
 
 namespace dg {
 namespace pta {
 
+#ifdef SHARED_POINTS_TO_SETS
+using PointsToSetT = SharedPointsToSet;
+#elif defined(CHUNKED_POINTS_TO_SETS)
+using PointsToSetT = ChunkedPointerIdPointsToSet;
+#elif defined(BDD_POINTS_TO_SETS)
+using PointsToSetT = BDDPointsToSet;
+#else
 using PointsToSetT = PointerIdPointsToSet;
+#endif
 using PointsToMapT = std::map<Offset, PointsToSetT>;
 
 } // namespace pta
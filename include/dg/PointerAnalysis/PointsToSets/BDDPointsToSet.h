@@ -0,0 +1,235 @@
+#ifndef DG_BDDPOINTSTOSET_H
+#define DG_BDDPOINTSTOSET_H
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "LookupTable.h"
+#include "dg/ADT/BDD.h"
+#include "dg/PointerAnalysis/Pointer.h"
+
+namespace dg {
+namespace pta {
+
+class PSNode;
+
+///
+// Points-to set represented by a binary decision diagram over the IDs
+// of pointers (see ADT::BDD). Sets with similar contents share the parts
+// of the diagrams, equal sets are the same node. The diagrams are stored
+// in the lookup table of pointer IDs (i.e., in the pointer graph).
+// Adding and merging are fast, iterating over the set is slower
+// than with the other sets, as the elements are enumerated from
+// the diagram.
+class BDDPointsToSet {
+    using IDTy = PointerIDLookupTable::IDTy;
+    using NodeID = ADT::BDD::NodeID;
+
+    // the table that assigns IDs to the pointers in this set
+    PointerIDLookupTable *lookupTable{&PointerIDLookupTable::current()};
+    NodeID _bdd{ADT::BDD::FALSE};
+
+    ADT::BDD &bdd() const { return lookupTable->getBDD(); }
+
+    bool update(NodeID n) {
+        if (n == _bdd)
+            return false;
+        _bdd = n;
+        return true;
+    }
+
+    bool contains(IDTy id) const {
+        return id != 0 && bdd().contains(_bdd, id);
+    }
+
+    bool insert(IDTy id) {
+        return update(bdd().insert(_bdd, id));
+    }
+
+    bool addWithUnknownOffset(PSNode *target) {
+        removeAny(target);
+        return insert(lookupTable->getOrCreate({target, Offset::UNKNOWN}));
+    }
+
+  public:
+    BDDPointsToSet() = default;
+    explicit BDDPointsToSet(const std::initializer_list<Pointer> &elems) {
+        add(elems);
+    }
+
+    bool add(PSNode *target, Offset off) { return add(Pointer(target, off)); }
+
+    bool add(const Pointer &ptr) {
+        if (has({ptr.target, Offset::UNKNOWN})) {
+            return false;
+        }
+        if (ptr.offset.isUnknown()) {
+            return addWithUnknownOffset(ptr.target);
+        }
+        const IDTy id = lookupTable->getOrCreate(ptr);
+        if (contains(id))
+            return false;
+        return insert(id);
+    }
+
+    template <typename ContainerTy>
+    bool add(const ContainerTy &C) {
+        bool changed = false;
+        for (const auto &ptr : C)
+            changed |= add(ptr);
+        return changed;
+    }
+
+    bool add(const BDDPointsToSet &S) {
+        if (S.lookupTable == lookupTable)
+            return update(bdd().unite(_bdd, S._bdd));
+
+        // the IDs come from a different table
+        bool changed = false;
+        for (const auto &ptr : S)
+            changed |= add(ptr);
+        return changed;
+    }
+
+    bool remove(const Pointer &ptr) {
+        const IDTy id = lookupTable->get(ptr);
+        if (!contains(id))
+            return false;
+        return update(bdd().subtract(_bdd, bdd().singleton(id)));
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target, offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        NodeID removed = ADT::BDD::FALSE;
+        bdd().enumerate(_bdd, [&](uint64_t id) {
+            if (lookupTable->get(id).target == target)
+                removed = bdd().insert(removed, id);
+        });
+        return update(bdd().subtract(_bdd, removed));
+    }
+
+    void clear() { _bdd = ADT::BDD::FALSE; }
+
+    bool pointsTo(const Pointer &ptr) const {
+        // do not create IDs for the queries
+        return contains(lookupTable->get(ptr));
+    }
+
+    bool mayPointTo(const Pointer &ptr) const {
+        return pointsTo(ptr) || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+    }
+
+    bool mustPointTo(const Pointer &ptr) const {
+        assert(!ptr.offset.isUnknown() && "Makes no sense");
+        return pointsTo(ptr) && isSingleton();
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        for (const auto &ptr : *this) {
+            if (ptr.target == target) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isSingleton() const { return size() == 1; }
+
+    bool empty() const { return _bdd == ADT::BDD::FALSE; }
+
+    size_t count(const Pointer &ptr) const { return pointsTo(ptr); }
+
+    bool has(const Pointer &ptr) const { return count(ptr) > 0; }
+
+    bool hasUnknown() const { return pointsToTarget(UNKNOWN_MEMORY); }
+
+    bool hasNull() const { return pointsToTarget(NULLPTR); }
+
+    bool hasNullWithOffset() const {
+        for (const auto &ptr : *this) {
+            if (ptr.target == NULLPTR && *ptr.offset != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool hasInvalidated() const { return pointsToTarget(INVALIDATED); }
+
+    size_t size() const { return bdd().count(_bdd); }
+
+    void swap(BDDPointsToSet &rhs) {
+        std::swap(_bdd, rhs._bdd);
+        std::swap(lookupTable, rhs.lookupTable);
+    }
+
+    // do the sets share the representation?
+    // (equal sets from the same table always do)
+    bool sharesWith(const BDDPointsToSet &rhs) const {
+        return _bdd == rhs._bdd && lookupTable == rhs.lookupTable;
+    }
+
+    const PointerIDLookupTable &getLookupTable() const { return *lookupTable; }
+
+    // iterates over the IDs enumerated from the diagram
+    class const_iterator {
+        std::shared_ptr<std::vector<IDTy>> ids;
+        size_t pos{0};
+        const PointerIDLookupTable *lookupTable{nullptr};
+
+        const_iterator(const BDDPointsToSet &S, bool end = false)
+                : lookupTable(S.lookupTable) {
+            if (end || S.empty())
+                return;
+
+            ids = std::make_shared<std::vector<IDTy>>();
+            S.bdd().enumerate(S._bdd,
+                              [this](uint64_t id) { ids->push_back(id); });
+        }
+
+        bool atEnd() const { return !ids || pos == ids->size(); }
+
+      public:
+        const_iterator &operator++() {
+            assert(!atEnd() && "operator++ called on end");
+            ++pos;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const { return {lookupTable->get((*ids)[pos])}; }
+
+        bool operator==(const const_iterator &rhs) const {
+            if (atEnd() || rhs.atEnd())
+                return atEnd() == rhs.atEnd();
+            return ids == rhs.ids && pos == rhs.pos;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class BDDPointsToSet;
+    };
+
+    const_iterator begin() const { return {*this}; }
+    const_iterator end() const { return {*this, true /* end */}; }
+
+    friend class const_iterator;
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif // DG_BDDPOINTSTOSET_H
@@ -1,7 +1,9 @@
 #ifndef DG_PTSETS_LOOKUPTABLE_H_
 #define DG_PTSETS_LOOKUPTABLE_H_
 
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <vector>
 
 #if defined(HAVE_TSL_HOPSCOTCH) || (__clang__)
@@ -10,6 +12,9 @@
 #include "dg/ADT/Map.h"
 #endif
 
+#include "dg/ADT/BDD.h"
+#include "dg/ADT/ConcurrentVector.h"
+#include "dg/ADT/InternedSets.h"
 #include "dg/Offset.h"
 #include "dg/PointerAnalysis/Pointer.h"
 
@@ -23,35 +28,124 @@ class PointerIDLookupTable {
 #if defined(HAVE_TSL_HOPSCOTCH) || (__clang__)
     using PtrToIDMap = dg::HashMap<PSNode *, dg::HashMap<dg::Offset, IDTy>>;
 #else
-    // we create the lookup table statically and there is a bug in GCC
+    // we create the default lookup table statically and there is a bug in GCC
     // that breaks statically created std::unordered_map.
     // So if we have not Hopscotch map, use std::map instead.
     using PtrToIDMap = dg::Map<PSNode *, dg::Map<dg::Offset, IDTy>>;
 #endif
 
+    using InternedSetsT = ADT::InternedSets<IDTy>;
+
+    explicit PointerIDLookupTable(bool concurrent = false)
+            : _concurrent(concurrent) {
+        _internedSets.setConcurrent(concurrent);
+        _bdd.setConcurrent(concurrent);
+    }
+    PointerIDLookupTable(const PointerIDLookupTable &) = delete;
+    PointerIDLookupTable &operator=(const PointerIDLookupTable &) = delete;
+
+    ///
+    // Every pointer graph has its own table, so that the IDs are dense
+    // and the graphs can be analyzed in parallel. The points-to sets
+    // take the table that is bound to the current thread when they are
+    // created (the pointer graph binds its table when it creates nodes
+    // and the analysis binds it while it runs). If no table is bound,
+    // the sets use the default table that is shared by all threads.
+    class Binding {
+        PointerIDLookupTable *_prev;
+
+      public:
+        explicit Binding(PointerIDLookupTable &table) : _prev(_current) {
+            _current = &table;
+        }
+        ~Binding() { _current = _prev; }
+
+        Binding(const Binding &) = delete;
+        Binding &operator=(const Binding &) = delete;
+    };
+
+    // the table bound to the current thread
+    static PointerIDLookupTable &current() {
+        return _current ? *_current : getDefault();
+    }
+
+    // the table used by sets created with no table bound
+    // (it is always concurrent)
+    static PointerIDLookupTable &getDefault();
+
+    // Use locking so that the table can be used from multiple threads
+    // at once (the parallel pointer analysis switches this on while
+    // it processes nodes in parallel).
+    void setConcurrent(bool b) {
+        _concurrent = b;
+        _internedSets.setConcurrent(b);
+        _bdd.setConcurrent(b);
+    }
+    bool isConcurrent() const { return _concurrent; }
+
+    // hash-consed sets of the IDs from this table
+    // (see SharedPointsToSet)
+    InternedSetsT &getInternedSets() { return _internedSets; }
+    const InternedSetsT &getInternedSets() const { return _internedSets; }
+
+    // binary decision diagrams over the IDs from this table
+    // (see BDDPointsToSet)
+    ADT::BDD &getBDD() { return _bdd; }
+    const ADT::BDD &getBDD() const { return _bdd; }
+
+    // the number of pointers that have an ID
+    size_t size() const { return _idToPtr.size(); }
+
     // this will get a new ID for the pointer if not present
     IDTy getOrCreate(const Pointer &ptr) {
-        auto res = get(ptr);
-        if (res != 0)
-            return res;
+        auto &shard = _shards[shardOf(ptr.target)];
+        if (!_concurrent)
+            return getOrCreate(shard, ptr);
 
-        _idToPtr.push_back(ptr);
-        res = _idToPtr.size();
-#ifndef NDEBUG
-        bool r =
-#endif
-                _ptrToID[ptr.target].put(ptr.offset, res);
-
-        assert(r && "Duplicated ID!");
-        assert(get(res) == ptr);
-        assert(res == get(ptr));
-        assert(res > 0 && "ID must always be greater than 0");
-        return res;
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return getOrCreate(shard, ptr);
     }
 
     IDTy get(const Pointer &ptr) const {
-        auto it = _ptrToID.find(ptr.target);
-        if (it == _ptrToID.end()) {
+        const auto &shard = _shards[shardOf(ptr.target)];
+        if (!_concurrent)
+            return get(shard, ptr);
+
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return get(shard, ptr);
+    }
+
+    // does not need locking, the pointers never move in the memory
+    // and the ID was assigned before anyone could get it
+    const Pointer &get(IDTy id) const {
+        assert(id - 1 < _idToPtr.size());
+        return _idToPtr[id - 1];
+    }
+
+  private:
+    // the map from pointers to IDs is split into shards
+    // that are locked separately
+    static const unsigned SHARDS_NUM = 64;
+
+    struct Shard {
+        // PSNode -> (Offset -> id)
+        // Not space efficient, but we need mainly the time efficiency
+        // here...
+        // NOTE: we cannot use the id of the target for hashing,
+        // the static nodes (UNKNOWN_MEMORY, NULLPTR, ...) are shared
+        // by all graphs and would clash with nodes of the graph.
+        PtrToIDMap ptrToID;
+        mutable std::mutex lock;
+    };
+
+    static unsigned shardOf(const PSNode *target) {
+        // the nodes are allocated on the heap, ignore the lower bits
+        return (reinterpret_cast<uintptr_t>(target) >> 4) % SHARDS_NUM;
+    }
+
+    static IDTy get(const Shard &shard, const Pointer &ptr) {
+        auto it = shard.ptrToID.find(ptr.target);
+        if (it == shard.ptrToID.end()) {
             return 0; // invalid ID
         }
         auto it2 = it->second.find(ptr.offset);
@@ -60,21 +154,32 @@ class PointerIDLookupTable {
         return it2->second;
     }
 
-    const Pointer &get(IDTy id) const {
-        assert(id - 1 < _idToPtr.size());
-        return _idToPtr[id - 1];
+    IDTy getOrCreate(Shard &shard, const Pointer &ptr) {
+        auto res = get(shard, ptr);
+        if (res != 0)
+            return res;
+
+        res = _idToPtr.push_back(ptr) + 1;
+#ifndef NDEBUG
+        bool r =
+#endif
+                shard.ptrToID[ptr.target].put(ptr.offset, res);
+
+        assert(r && "Duplicated ID!");
+        assert(get(res) == ptr);
+        assert(res == get(shard, ptr));
+        assert(res > 0 && "ID must always be greater than 0");
+        return res;
     }
 
-  private:
-    // PSNode -> (Offset -> id)
-    // Not space efficient, but we need mainly the time efficiency here...
-    // NOTE: unfortunately, atm, we cannot use the id of the target for hashing
-    // because it would break repeated runs of the analysis
-    // as multiple graphs will contain nodes with the same id
-    // (and resetting the state is really painful, I tried that,
-    // but just didn't succeed).
-    PtrToIDMap _ptrToID;
-    std::vector<Pointer> _idToPtr; // starts from 0 (pointer = idVector[id - 1])
+    static thread_local PointerIDLookupTable *_current;
+
+    Shard _shards[SHARDS_NUM];
+    // starts from 0 (pointer = _idToPtr[id - 1])
+    ADT::ConcurrentVector<Pointer> _idToPtr;
+    InternedSetsT _internedSets;
+    ADT::BDD _bdd;
+    bool _concurrent{false};
 };
 
 /*
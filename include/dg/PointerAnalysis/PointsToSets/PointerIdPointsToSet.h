@@ -3,10 +3,12 @@
 
 #include <cassert>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "LookupTable.h"
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/ChunkedBitvector.h"
 #include "dg/PointerAnalysis/Pointer.h"
 
 namespace dg {
@@ -14,22 +16,21 @@ namespace pta {
 
 class PSNode;
 
-class PointerIdPointsToSet {
-    static PointerIDLookupTable lookupTable;
+// Points-to set that stores the IDs of pointers (see PointerIDLookupTable)
+// in a bitvector of type PointersT.
+template <typename PointersT>
+class PointerIdPointsToSetImpl {
+    // the table that assigns IDs to the pointers in this set
+    PointerIDLookupTable *lookupTable{&PointerIDLookupTable::current()};
 
-#if defined(HAVE_TSL_HOPSCOTCH) || (__clang__)
-    using PointersT = ADT::SparseBitvectorHashImpl;
-#else
-    using PointersT = ADT::SparseBitvector;
-#endif
     PointersT pointers;
 
     // if the pointer doesn't have ID, it's assigned one
-    static size_t getPointerID(const Pointer &ptr) {
-        return lookupTable.getOrCreate(ptr);
+    size_t getPointerID(const Pointer &ptr) const {
+        return lookupTable->getOrCreate(ptr);
     }
 
-    static const Pointer &getPointer(size_t id) { return lookupTable.get(id); }
+    const Pointer &getPointer(size_t id) const { return lookupTable->get(id); }
 
     bool addWithUnknownOffset(PSNode *node) {
         auto ptrid = getPointerID({node, Offset::UNKNOWN});
@@ -41,8 +42,8 @@ class PointerIdPointsToSet {
     }
 
   public:
-    PointerIdPointsToSet() = default;
-    explicit PointerIdPointsToSet(const std::initializer_list<Pointer> &elems) {
+    PointerIdPointsToSetImpl() = default;
+    explicit PointerIdPointsToSetImpl(const std::initializer_list<Pointer> &elems) {
         add(elems);
     }
 
@@ -66,7 +67,16 @@ class PointerIdPointsToSet {
         return changed;
     }
 
-    bool add(const PointerIdPointsToSet &S) { return pointers.set(S.pointers); }
+    bool add(const PointerIdPointsToSetImpl &S) {
+        if (S.lookupTable == lookupTable)
+            return pointers.set(S.pointers);
+
+        // the IDs come from a different table
+        bool changed = false;
+        for (const auto &ptr : S)
+            changed |= add(ptr);
+        return changed;
+    }
 
     bool remove(const Pointer &ptr) {
         return pointers.unset(getPointerID(ptr));
@@ -81,7 +91,7 @@ class PointerIdPointsToSet {
         tmp.reserve(pointers.size());
         bool removed = false;
         for (const auto &ptrID : pointers) {
-            if (lookupTable.get(ptrID).target != target) {
+            if (getPointer(ptrID).target != target) {
                 tmp.set(ptrID);
             } else {
                 removed = true;
@@ -96,7 +106,8 @@ class PointerIdPointsToSet {
     void clear() { pointers.reset(); }
 
     bool pointsTo(const Pointer &ptr) const {
-        return pointers.get(getPointerID(ptr));
+        // do not create IDs for the queries, 0 is never in the set
+        return pointers.get(lookupTable->get(ptr));
     }
 
     bool mayPointTo(const Pointer &ptr) const {
@@ -145,13 +156,20 @@ class PointerIdPointsToSet {
 
     size_t size() const { return pointers.size(); }
 
-    void swap(PointerIdPointsToSet &rhs) { pointers.swap(rhs.pointers); }
+    void swap(PointerIdPointsToSetImpl &rhs) {
+        pointers.swap(rhs.pointers);
+        std::swap(lookupTable, rhs.lookupTable);
+    }
+
+    const PointerIDLookupTable &getLookupTable() const { return *lookupTable; }
 
     class const_iterator {
         typename PointersT::const_iterator container_it;
+        const PointerIDLookupTable *lookupTable;
 
-        const_iterator(const PointersT &pointers, bool end = false)
-                : container_it(end ? pointers.end() : pointers.begin()) {}
+        const_iterator(const PointerIdPointsToSetImpl &S, bool end = false)
+                : container_it(end ? S.pointers.end() : S.pointers.begin()),
+                  lookupTable(S.lookupTable) {}
 
       public:
         const_iterator &operator++() {
@@ -165,7 +183,7 @@ class PointerIdPointsToSet {
             return tmp;
         }
 
-        Pointer operator*() const { return {lookupTable.get(*container_it)}; }
+        Pointer operator*() const { return {lookupTable->get(*container_it)}; }
 
         bool operator==(const const_iterator &rhs) const {
             return container_it == rhs.container_it;
@@ -175,15 +193,25 @@ class PointerIdPointsToSet {
             return !operator==(rhs);
         }
 
-        friend class PointerIdPointsToSet;
+        friend class PointerIdPointsToSetImpl;
     };
 
-    const_iterator begin() const { return {pointers}; }
-    const_iterator end() const { return {pointers, true /* end */}; }
+    const_iterator begin() const { return {*this}; }
+    const_iterator end() const { return {*this, true /* end */}; }
 
     friend class const_iterator;
 };
 
+#if defined(HAVE_TSL_HOPSCOTCH) || (__clang__)
+using PointerIdPointsToSet =
+        PointerIdPointsToSetImpl<ADT::SparseBitvectorHashImpl>;
+#else
+using PointerIdPointsToSet = PointerIdPointsToSetImpl<ADT::SparseBitvector>;
+#endif
+// better if the IDs are dense (e.g., in big programs)
+using ChunkedPointerIdPointsToSet =
+        PointerIdPointsToSetImpl<ADT::ChunkedBitvector>;
+
 } // namespace pta
 } // namespace dg
 
@@ -0,0 +1,218 @@
+#ifndef DG_SHAREDPOINTSTOSET_H
+#define DG_SHAREDPOINTSTOSET_H
+
+#include <cassert>
+#include <utility>
+
+#include "LookupTable.h"
+#include "dg/PointerAnalysis/Pointer.h"
+
+namespace dg {
+namespace pta {
+
+class PSNode;
+
+///
+// Points-to set that is only a reference to an immutable hash-consed set
+// of pointer IDs (see ADT::InternedSets). Equal sets share the memory,
+// copying a set is cheap and the results of merging sets are memoized.
+// The sets are stored in the lookup table of pointer IDs
+// (i.e., in the pointer graph) and live as long as the table.
+class SharedPointsToSet {
+    using IDTy = PointerIDLookupTable::IDTy;
+    using SetT = PointerIDLookupTable::InternedSetsT::Set;
+
+    // the table that assigns IDs to the pointers in this set
+    PointerIDLookupTable *lookupTable{&PointerIDLookupTable::current()};
+    // nullptr is the empty set
+    const SetT *_set{nullptr};
+
+    PointerIDLookupTable::InternedSetsT &sets() const {
+        return lookupTable->getInternedSets();
+    }
+
+    const Pointer &getPointer(IDTy id) const { return lookupTable->get(id); }
+
+    bool contains(IDTy id) const {
+        return id != 0 && _set && _set->contains(id);
+    }
+
+    bool update(const SetT *S) {
+        if (S == _set)
+            return false;
+        _set = S;
+        return true;
+    }
+
+    bool addWithUnknownOffset(PSNode *target) {
+        removeAny(target);
+        return update(sets().insert(
+                _set, lookupTable->getOrCreate({target, Offset::UNKNOWN})));
+    }
+
+  public:
+    SharedPointsToSet() = default;
+    explicit SharedPointsToSet(const std::initializer_list<Pointer> &elems) {
+        add(elems);
+    }
+
+    bool add(PSNode *target, Offset off) { return add(Pointer(target, off)); }
+
+    bool add(const Pointer &ptr) {
+        if (has({ptr.target, Offset::UNKNOWN})) {
+            return false;
+        }
+        if (ptr.offset.isUnknown()) {
+            return addWithUnknownOffset(ptr.target);
+        }
+        return update(sets().insert(_set, lookupTable->getOrCreate(ptr)));
+    }
+
+    template <typename ContainerTy>
+    bool add(const ContainerTy &C) {
+        bool changed = false;
+        for (const auto &ptr : C)
+            changed |= add(ptr);
+        return changed;
+    }
+
+    bool add(const SharedPointsToSet &S) {
+        if (S.lookupTable == lookupTable)
+            return update(sets().getUnion(_set, S._set));
+
+        // the IDs come from a different table
+        bool changed = false;
+        for (const auto &ptr : S)
+            changed |= add(ptr);
+        return changed;
+    }
+
+    bool remove(const Pointer &ptr) {
+        const IDTy id = lookupTable->get(ptr);
+        if (!contains(id))
+            return false;
+        return update(sets().filter(_set, [id](IDTy x) { return x != id; }));
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target, offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        return update(sets().filter(_set, [this, target](IDTy x) {
+            return getPointer(x).target != target;
+        }));
+    }
+
+    void clear() { _set = nullptr; }
+
+    bool pointsTo(const Pointer &ptr) const {
+        // do not create IDs for the queries
+        return contains(lookupTable->get(ptr));
+    }
+
+    bool mayPointTo(const Pointer &ptr) const {
+        return pointsTo(ptr) || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+    }
+
+    bool mustPointTo(const Pointer &ptr) const {
+        assert(!ptr.offset.isUnknown() && "Makes no sense");
+        return pointsTo(ptr) && isSingleton();
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        for (const auto &ptr : *this) {
+            if (ptr.target == target) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isSingleton() const { return size() == 1; }
+
+    bool empty() const { return _set == nullptr; }
+
+    size_t count(const Pointer &ptr) const { return pointsTo(ptr); }
+
+    bool has(const Pointer &ptr) const { return count(ptr) > 0; }
+
+    bool hasUnknown() const { return pointsToTarget(UNKNOWN_MEMORY); }
+
+    bool hasNull() const { return pointsToTarget(NULLPTR); }
+
+    bool hasNullWithOffset() const {
+        for (const auto &ptr : *this) {
+            if (ptr.target == NULLPTR && *ptr.offset != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool hasInvalidated() const { return pointsToTarget(INVALIDATED); }
+
+    size_t size() const { return _set ? _set->size() : 0; }
+
+    void swap(SharedPointsToSet &rhs) {
+        std::swap(_set, rhs._set);
+        std::swap(lookupTable, rhs.lookupTable);
+    }
+
+    // do the sets share the representation?
+    // (equal sets from the same table always do)
+    bool sharesWith(const SharedPointsToSet &rhs) const {
+        return _set == rhs._set && lookupTable == rhs.lookupTable;
+    }
+
+    const PointerIDLookupTable &getLookupTable() const { return *lookupTable; }
+
+    class const_iterator {
+        const IDTy *it;
+        const PointerIDLookupTable *lookupTable;
+
+        const_iterator(const SharedPointsToSet &S, bool end = false)
+                : it(nullptr), lookupTable(S.lookupTable) {
+            if (S._set) {
+                it = &*S._set->begin();
+                if (end)
+                    it += S._set->size();
+            }
+        }
+
+      public:
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const { return {lookupTable->get(*it)}; }
+
+        bool operator==(const const_iterator &rhs) const {
+            return it == rhs.it;
+        }
+
+        bool operator!=(const const_iterator &rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class SharedPointsToSet;
+    };
+
+    const_iterator begin() const { return {*this}; }
+    const_iterator end() const { return {*this, true /* end */}; }
+
+    friend class const_iterator;
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif // DG_SHAREDPOINTSTOSET_H
@@ -0,0 +1,63 @@
+#ifndef DG_POINTER_ANALYSIS_WAVE_SCHEDULER_H_
+#define DG_POINTER_ANALYSIS_WAVE_SCHEDULER_H_
+
+#include <cassert>
+#include <vector>
+
+#include "dg/PointerAnalysis/PSNode.h"
+#include "dg/PointerAnalysis/PointerGraph.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Scheduler of nodes for the wave propagation
+// (see PointerAnalysisOptions::Scheduler::WAVE).
+//
+// The nodes are ordered by the topological order of the constraint graph
+// (edges go from operands to their users) condensed to SCCs. Every
+// iteration (wave) of the analysis processes the same nodes as with
+// the BFS scheduler (all nodes reachable from the changed nodes),
+// but in this order, so that a node is processed after its operands
+// and the pointers get as far as possible in a single iteration.
+// Flow-sensitive analyses need the order to follow also the control flow
+// (a node takes the memory map from its predecessor).
+class WaveScheduler {
+    PointerGraph *PG;
+    // add the control flow edges to the constraint graph
+    const bool _controlFlow;
+
+    // topological index of the SCC of every node (indexed by node IDs)
+    std::vector<unsigned> _order;
+    // the last wave in which the node was queued (indexed by node IDs)
+    std::vector<unsigned> _queued;
+    unsigned _wave{0};
+    unsigned _sccsNum{0};
+    bool _valid{false};
+
+    void computeOrder();
+
+  public:
+    WaveScheduler(PointerGraph *pg, bool controlFlow = false)
+            : PG(pg), _controlFlow(controlFlow) {}
+
+    // the graph changed (e.g., new call edges were added),
+    // we must recompute the order before the next wave
+    void invalidate() { _valid = false; }
+
+    unsigned getIndex(const PSNode *n) const {
+        assert(n->getID() < _order.size() && "The node has no index");
+        return _order[n->getID()];
+    }
+
+    unsigned getSCCsNum() const { return _sccsNum; }
+
+    // get the nodes reachable from 'changed' in the topological order
+    std::vector<PSNode *> getNodes(const std::vector<PSNode *> &changed,
+                                   unsigned expected_num = 0);
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif
@@ -346,6 +346,34 @@ class SubgraphNode {
         users.clear();
     }
 
+    // remove 'this' from the operands of every user
+    void removeAllUses() {
+        for (NodeT *user : users) {
+            auto &ops = user->operands;
+            ops.erase(std::remove(ops.begin(), ops.end(), this), ops.end());
+        }
+
+        users.clear();
+    }
+
+    // remove all the edges from and to this node. Unlike isolate(),
+    // the predecessors are not connected to the successors.
+    void removeAllEdges() {
+        for (NodeT *pred : _predecessors) {
+            auto &succs = pred->_successors;
+            succs.erase(std::remove(succs.begin(), succs.end(), this),
+                        succs.end());
+        }
+
+        for (NodeT *succ : _successors) {
+            if (succ != this)
+                _removeThisFromSuccessorsPredecessors(succ);
+        }
+
+        _successors.clear();
+        _predecessors.clear();
+    }
+
     size_t predecessorsNum() const { return _predecessors.size(); }
 
     size_t successorsNum() const { return _successors.size(); }
@@ -1,6 +1,8 @@
 #ifndef DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 #define DG_LLVM_POINTER_ANALYSIS_OPTIONS_H_
 
+#include <string>
+
 #include "dg/PointerAnalysis/PointerAnalysisOptions.h"
 #include "dg/llvm/LLVMAnalysisOptions.h"
 
@@ -8,14 +10,42 @@ namespace dg {
 
 struct LLVMPointerAnalysisOptions : public LLVMAnalysisOptions,
                                     PointerAnalysisOptions {
-    enum class AnalysisType { fi, fs, inv, svf } analysisType{AnalysisType::fi};
+    enum class AnalysisType {
+        fi,
+        fs,
+        inv,
+        svf,
+        sfs,
+        demand
+    } analysisType{AnalysisType::fi};
 
     bool threads{false};
 
+    // Do not build the functions that do not work with pointers
+    // and treat their direct calls as no-ops.
+    bool summarizePointerFree{false};
+
+    // Do not build the functions that do not write to memory
+    // and build their direct calls from summaries of the returned
+    // pointers. The summaries are computed bottom-up over the calls.
+    bool summaries{false};
+    // The file where the summaries are stored between runs
+    // (if not empty). Implies summaries.
+    std::string summaryCache{};
+
+    // Clone the subgraphs of allocation wrappers (functions that return
+    // memory allocated on heap in them or in their callees) for every
+    // call site, so that the memory allocated via different call sites
+    // is not merged. The number is the length of the call strings
+    // (k in k-callsite sensitivity), 0 turns the cloning off.
+    unsigned contextSensitivity{0};
+
     bool isFS() const { return analysisType == AnalysisType::fs; }
     bool isFSInv() const { return analysisType == AnalysisType::inv; }
     bool isFI() const { return analysisType == AnalysisType::fi; }
     bool isSVF() const { return analysisType == AnalysisType::svf; }
+    bool isSFS() const { return analysisType == AnalysisType::sfs; }
+    bool isDemand() const { return analysisType == AnalysisType::demand; }
 };
 
 } // namespace dg
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/Function.h>
@@ -10,9 +11,11 @@
 
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointerAnalysis.h"
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
 #include "dg/PointerAnalysis/PointerAnalysisFI.h"
 #include "dg/PointerAnalysis/PointerAnalysisFS.h"
 #include "dg/PointerAnalysis/PointerAnalysisFSInv.h"
+#include "dg/PointerAnalysis/PointerAnalysisSFS.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
 #include "dg/PointerAnalysis/PointerGraphOptimizations.h"
 
@@ -176,6 +179,8 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
     PointerGraph *PS = nullptr;
     std::unique_ptr<pta::PointerAnalysis> PTA{}; // dg pointer analysis object
     std::unique_ptr<LLVMPointerGraphBuilder> _builder;
+    // set if the points-to sets are computed on queries (it is PTA)
+    pta::PointerAnalysisDemand *_demand{nullptr};
 
     static LLVMPointerAnalysisOptions createOptions(const char *entry_func,
                                                     uint64_t field_sensitivity,
@@ -209,9 +214,13 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
 
     ///
     // Get the node from pointer analysis that holds the points-to set.
-    // See: getLLVMPointsTo()
+    // With the demand-driven analysis, the points-to set of the node
+    // is computed here. See: getLLVMPointsTo()
     PSNode *getPointsToNode(const llvm::Value *val) const {
-        return _builder->getPointsToNode(val);
+        PSNode *node = _builder->getPointsToNode(val);
+        if (node && _demand)
+            _demand->query(node);
+        return node;
     }
 
     pta::PointerAnalysis *getPTA() { return PTA.get(); }
@@ -281,6 +290,15 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
     LLVMPointerGraphBuilder *getBuilder() { return _builder.get(); }
     const LLVMPointerGraphBuilder *getBuilder() const { return _builder.get(); }
 
+    void mergeEquivalentNodes() {
+        pta::PSPointerEquivalenceMerger merger(PS);
+        for (PSNode *arg : _builder->getArgumentNodes())
+            merger.setOpaque(arg);
+
+        if (merger.run() > 0)
+            _builder->composeMapping(std::move(merger.getMapping()));
+    }
+
     void buildSubgraph() {
         // run the analysis itself
         assert(_builder && "Incorrectly constructed PTA, missing builder");
@@ -291,6 +309,9 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
             abort();
         }
 
+        if (options.mergeEquivalentNodes)
+            mergeEquivalentNodes();
+
         /*
         pta::PointerGraphOptimizer optimizer(PS);
         optimizer.run();
@@ -319,6 +340,13 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
         } else if (options.isFSInv()) {
             PTA.reset(new DGLLVMPointerAnalysisImpl<pta::PointerAnalysisFSInv>(
                     PS, _builder.get(), options));
+        } else if (options.isSFS()) {
+            PTA.reset(new DGLLVMPointerAnalysisImpl<pta::PointerAnalysisSFS>(
+                    PS, _builder.get(), options));
+        } else if (options.isDemand()) {
+            _demand = new DGLLVMPointerAnalysisImpl<pta::PointerAnalysisDemand>(
+                    PS, _builder.get(), options);
+            PTA.reset(_demand);
         } else {
             assert(0 && "Wrong pointer analysis");
             abort();
@@ -329,8 +357,28 @@ class DGLLVMPointerAnalysis : public LLVMPointerAnalysis {
         if (!PTA) {
             initialize();
         }
-        return PTA->run();
+        // the points-to sets are computed on queries
+        if (_demand)
+            return true;
+        bool ret = PTA->run();
+        _builder->mergeClonedPointsTo();
+        return ret;
     }
+
+    ///
+    // Update the results after the module was edited. 'changed' are
+    // the functions that were added or whose bodies changed and 'removed'
+    // are the functions that were deleted from the module (these pointers
+    // are never dereferenced). Globals must not be added or removed.
+    //
+    // The flow-insensitive analysis rebuilds only the subgraphs
+    // of the changed functions and continues from the previous fixpoint.
+    // The points-to sets (and memory objects) that may contain pointers
+    // from the old subgraphs are cleared before and computed again.
+    // Other analyses (and the configurations that change the graph
+    // in other ways, e.g., summaries or threads) run from scratch.
+    bool update(const std::vector<const llvm::Function *> &changed,
+                const std::vector<const llvm::Function *> &removed = {});
 };
 
 // an auxiliary function
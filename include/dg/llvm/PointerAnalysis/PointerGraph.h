@@ -1,7 +1,11 @@
 #ifndef LLVM_DG_POINTER_SUBGRAPH_H_
 #define LLVM_DG_POINTER_SUBGRAPH_H_
 
+#include <map>
+#include <memory>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DataLayout.h>
@@ -11,6 +15,7 @@
 #include <llvm/Support/raw_os_ostream.h>
 
 #include "dg/llvm/PointerAnalysis/LLVMPointerAnalysisOptions.h"
+#include "dg/llvm/PointerAnalysis/PointerSummaries.h"
 
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
@@ -201,8 +206,29 @@ class LLVMPointerGraphBuilder {
     std::vector<PSNodeFork *> forkNodes;
     std::vector<PSNodeJoin *> joinNodes;
 
+    // context sensitivity (see LLVMPointerAnalysisOptions::contextSensitivity)
+    struct ClonedSubgraph {
+        const llvm::Function *function;
+        // original nodes -> the nodes of the clone
+        std::unordered_map<PSNode *, PSNode *> nodes;
+    };
+    std::unordered_map<const PointerSubgraph *, ClonedSubgraph> _clones;
+    // pairs (cloned node, original node)
+    std::vector<std::pair<PSNode *, PSNode *>> _clonedNodes;
+
+    void cloneAllocationWrappers();
+    std::vector<PointerSubgraph *> getAllocationWrappers(
+            const std::map<PointerSubgraph *, std::vector<PSNode *>> &nodes);
+    PointerSubgraph *cloneSubgraph(PointerSubgraph *subg,
+                                   const std::vector<PSNode *> &nodes);
+    PSNode *getNodeInSubgraph(const PointerSubgraph *subg, PSNode *nd) const;
+    void setArgumentsFromCallers(const llvm::Function *F,
+                                 PointerSubgraph *subg);
+    void setReturnsFromCallees(PSNode *callNode);
+
   public:
     const PointerGraph *getPS() const { return &PS; }
+    const llvm::Module *getModule() const { return M; }
 
     inline bool threads() const { return threads_; }
 
@@ -273,11 +299,48 @@ class LLVMPointerGraphBuilder {
     }
 
     void composeMapping(PointsToMapping<PSNode *> &&rhs) {
+        // the nodes of the values could have been removed too
+        for (auto &it : nodes_map) {
+            PSNode *repr = it.second.getRepresentant();
+            PSNode *mapped = rhs.getFinal(repr);
+            if (mapped != repr)
+                it.second.setRepresentant(mapped);
+        }
+        for (auto &it : _clonedNodes) {
+            it.first = rhs.getFinal(it.first);
+            it.second = rhs.getFinal(it.second);
+        }
         mapping.compose(std::move(rhs));
     }
 
+    // add the points-to sets of the cloned nodes to the original nodes,
+    // so that the values in cloned functions have the points-to sets
+    // from all contexts
+    void mergeClonedPointsTo() {
+        for (auto &it : _clonedNodes)
+            it.second->addPointsTo(it.first->pointsTo);
+    }
+
+    // the nodes of arguments of functions, these get new operands
+    // when a new call of the function is found during the analysis
+    std::vector<PSNode *> getArgumentNodes();
+
     PointerSubgraph *getSubgraph(const llvm::Function * /*F*/);
 
+    // Incremental building (see DGLLVMPointerAnalysis::update()).
+    // Can the subgraphs of the changed functions be built again
+    // without building the rest of the graph again?
+    bool
+    canRebuildFunctions(const std::set<const llvm::Function *> &changed) const;
+    // the nodes of the subgraphs of the functions
+    std::vector<PSNode *>
+    getSubgraphsNodes(const std::set<const llvm::Function *> &functions);
+    // remove the subgraphs of the changed and removed functions
+    // and build again the changed functions that are called
+    // from the rest of the graph
+    void rebuildFunctions(const std::set<const llvm::Function *> &changed,
+                          const std::set<const llvm::Function *> &removed);
+
   private:
     // create subgraph of function @F (the nodes)
     // and call+return nodes to/from it. This function
@@ -330,6 +393,36 @@ class LLVMPointerGraphBuilder {
 
     bool isRelevantInstruction(const llvm::Instruction &Inst);
 
+    // Functions that do not work with pointers (no pointer values,
+    // no memory accesses, no calls of other functions than pointer-free)
+    // can not change the points-to information. With
+    // LLVMPointerAnalysisOptions::summarizePointerFree, direct calls
+    // of these functions are not built (they are no-ops)
+    // and neither are the functions themselves.
+    std::unordered_map<const llvm::Function *, bool> _pointerFree;
+    bool isPointerFree(const llvm::Function *F);
+    bool computeIsPointerFree(const llvm::Function *F);
+    // return the called function if Inst is a direct call
+    // of a pointer-free function that we do not build
+    const llvm::Function *getPointerFreeCallee(const llvm::Value *val);
+
+    // Functions that do not write to memory are not built with
+    // LLVMPointerAnalysisOptions::summaries, their direct calls
+    // are built from their summaries (see PointerSummaries.h).
+    std::unique_ptr<LLVMPointerSummaries> _summaries;
+    // return the called function if Inst is a direct call
+    // of a pointer-free or summarized function that we do not build
+    const llvm::Function *getSummarizedCallee(const llvm::Value *val);
+    // return the summary if Inst is a direct call of a summarized
+    // function that returns a pointer
+    const PointerSummary *getCallSummary(const llvm::Value *val);
+    PSNodesSeq &createSummarizedCall(const llvm::CallInst *CInst,
+                                     const PointerSummary &S);
+    // add the call and the calls from the (not built) function
+    // to the call graph
+    void registerSummarizedCall(const llvm::Function *caller,
+                                const llvm::Function *F);
+
     PSNodesSeq &createAlloc(const llvm::Instruction *Inst);
     PSNode *createDynamicAlloc(const llvm::CallInst *CInst,
                                AllocationFunction type);
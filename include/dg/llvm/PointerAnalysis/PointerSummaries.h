@@ -0,0 +1,122 @@
+#ifndef DG_LLVM_POINTER_SUMMARIES_H_
+#define DG_LLVM_POINTER_SUMMARIES_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include "dg/Offset.h"
+#include "dg/llvm/PointerAnalysis/LLVMPointerAnalysisOptions.h"
+
+namespace dg {
+namespace pta {
+
+///
+// Summary of a function that does not write to memory. Such a function
+// can change the points-to information only by the pointer that
+// it returns. The returned pointers are described by access paths that
+// start in an argument, a global, or a new heap object and continue
+// with shifting the pointer and loading from memory, e.g.,
+// *(arg0 + 8) is the pointer stored at offset 8 of the object
+// pointed by the first argument.
+//
+// A call of a summarized function is built as the nodes that evaluate
+// the paths in the caller instead of the call of the function's subgraph.
+struct PointerSummary {
+    struct Step {
+        // load from memory or shift the pointer by offset
+        bool load{false};
+        Offset offset{0};
+
+        bool operator==(const Step &rhs) const {
+            return load == rhs.load && offset == rhs.offset;
+        }
+    };
+
+    struct Path {
+        enum class Source { ARGUMENT, GLOBAL, NULLPTR, UNKNOWN, HEAP };
+
+        Source source{Source::UNKNOWN};
+        // the index of the argument
+        unsigned arg{0};
+        // global variable or function, or the call that allocates
+        // the heap object
+        const llvm::Value *value{nullptr};
+        // the size of the heap object (0 is unknown)
+        uint64_t size{0};
+        bool zeroInitialized{false};
+
+        std::vector<Step> steps;
+
+        bool operator==(const Path &rhs) const {
+            return source == rhs.source && arg == rhs.arg &&
+                   value == rhs.value && size == rhs.size &&
+                   zeroInitialized == rhs.zeroInitialized &&
+                   steps == rhs.steps;
+        }
+    };
+
+    // the paths of the returned pointers, empty if the function
+    // does not return a pointer
+    std::vector<Path> returns;
+};
+
+///
+// Computes the summaries of functions bottom-up over the direct calls.
+// The summaries can be stored into a file and reused by other runs
+// (e.g., on other modules that link the same libraries). A stored summary
+// is used only if the function and the functions that it calls did not
+// change.
+class LLVMPointerSummaries {
+    const llvm::Module *M;
+    const LLVMPointerAnalysisOptions &_options;
+    bool _invalidateNodes;
+
+    // null if the function can not be summarized
+    std::unordered_map<const llvm::Function *, std::unique_ptr<PointerSummary>>
+            _summaries;
+
+    struct CacheEntry {
+        uint64_t hash;
+        // the summary in the textual form, "none" if there is no summary
+        std::string summary;
+    };
+    // function name -> entry
+    std::map<std::string, CacheEntry> _cache;
+    std::unordered_map<const llvm::Function *, uint64_t> _hashes;
+    bool _cacheChanged{false};
+
+    std::unique_ptr<PointerSummary> compute(const llvm::Function *F);
+    uint64_t getHash(const llvm::Function *F);
+
+    std::string toString(const PointerSummary *S) const;
+    // parse the string from toString(), S is null for "none"
+    bool fromString(const std::string &str,
+                    std::unique_ptr<PointerSummary> &S) const;
+
+  public:
+    LLVMPointerSummaries(const llvm::Module *m,
+                         const LLVMPointerAnalysisOptions &opts,
+                         bool invalidateNodes)
+            : M(m), _options(opts), _invalidateNodes(invalidateNodes) {}
+
+    // get the summary of F or nullptr if F can not be summarized
+    const PointerSummary *get(const llvm::Function *F);
+
+    // read the summaries stored by save(), return false
+    // if the file could not be read
+    bool load(const std::string &path);
+    // store the summaries (also those read by load()),
+    // return false if the file could not be written
+    bool save(const std::string &path) const;
+};
+
+} // namespace pta
+} // namespace dg
+
+#endif
@@ -18,6 +18,12 @@ class cow_shared_ptr : public std::shared_ptr<T> {
     cow_shared_ptr(const cow_shared_ptr &rhs)
             : std::shared_ptr<T>(rhs), owner(false) {}
 
+    cow_shared_ptr &operator=(const cow_shared_ptr &rhs) {
+        std::shared_ptr<T>::operator=(rhs);
+        owner = false;
+        return *this;
+    }
+
     void reset(T *p) {
         owner = true;
         std::shared_ptr<T>::reset(p);
@@ -28,11 +34,15 @@ class cow_shared_ptr : public std::shared_ptr<T> {
     const T *operator*() const { return get(); }
 
     T *getWritable() {
-        if (owner)
+        // the object can be modified in place only if nobody else
+        // shares it (also the owner must copy the object
+        // once a copy of the pointer has been made)
+        if (std::shared_ptr<T>::use_count() == 1) {
+            owner = true;
             return std::shared_ptr<T>::get();
+        }
 
         // create a copy of the object and claim the ownership
-        assert(!owner);
         if (get() != nullptr) {
             reset(new T(*get()));
         } else {
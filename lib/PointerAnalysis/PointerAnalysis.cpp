@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "dg/PointerAnalysis/PointerAnalysis.h"
 #include "dg/PointerAnalysis/Pointer.h"
 #include "dg/PointerAnalysis/PointsToSet.h"
@@ -31,6 +37,42 @@ static bool funHasAddressTaken(PSNode *node) {
     });
 }
 
+// the number of nodes that a thread takes at once
+// in the parallel iteration
+static const size_t PARALLEL_CHUNK = 64;
+
+// Call 'F(t)' in 'threadsNum' threads (t is the index of the thread,
+// the 0-th is the calling thread) and wait until they finish
+template <typename FunT>
+static void runInThreads(unsigned threadsNum, const FunT &F) {
+    std::vector<std::thread> threads;
+    threads.reserve(threadsNum - 1);
+    for (unsigned t = 1; t < threadsNum; ++t)
+        threads.emplace_back(F, t);
+    F(0);
+    for (auto &thr : threads)
+        thr.join();
+}
+
+// Call 'F' on points-to sets that contain the pointers of the 'idx'-th
+// operand of 'node' that may have not been propagated to 'node' yet.
+// With difference propagation, these are only the pointers that were added
+// to the operand since 'node' was processed the last time (if we know them),
+// otherwise it is the whole points-to set of the operand.
+template <typename FunT>
+static bool forNewPointsTo(PSNode *node, size_t idx, const FunT &F) {
+    PSNode *op = node->getOperand(idx);
+    PointsToDelta *delta = node->getDelta();
+    PointsToDelta *opDelta = op->getDelta();
+    if (delta && opDelta && opDelta->coversChangesFor(*delta, idx)) {
+        bool changed = F(opDelta->previous());
+        changed |= F(opDelta->current());
+        return changed;
+    }
+
+    return F(op->pointsTo);
+}
+
 bool PointerAnalysis::processLoad(PSNode *node) {
     bool changed = false;
     PSNode *operand = node->getOperand(0);
@@ -275,23 +317,30 @@ bool PointerAnalysis::processGep(PSNode *node) {
     PSNodeGep *gep = PSNodeGep::get(node);
     assert(gep && "Non-GEP given");
 
-    for (const Pointer &ptr : gep->getSource()->pointsTo) {
-        Offset::type new_offset;
-        if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
-            // set it like this to avoid overflow when adding
-            new_offset = Offset::UNKNOWN;
-        else
-            new_offset = *ptr.offset + *gep->getOffset();
-
-        // in the case PSNodeType::the memory has size 0, then every pointer
-        // will have unknown offset with the exception that it points
-        // to the begining of the memory - therefore make 0 exception
-        if ((new_offset == 0 || new_offset < ptr.target->getSize()) &&
-            new_offset < *options.fieldSensitivity)
-            changed |= node->addPointsTo(ptr.target, new_offset);
-        else
-            changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
-    }
+    auto shift = [&](const PointsToSetT &S) {
+        bool ch = false;
+        for (const Pointer &ptr : S) {
+            Offset::type new_offset;
+            if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
+                // set it like this to avoid overflow when adding
+                new_offset = Offset::UNKNOWN;
+            else
+                new_offset = *ptr.offset + *gep->getOffset();
+
+            // in the case PSNodeType::the memory has size 0, then every
+            // pointer will have unknown offset with the exception that it
+            // points to the begining of the memory - therefore make 0
+            // exception
+            if ((new_offset == 0 || new_offset < ptr.target->getSize()) &&
+                new_offset < *options.fieldSensitivity)
+                ch |= node->addPointsTo(ptr.target, new_offset);
+            else
+                ch |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
+        }
+        return ch;
+    };
+
+    changed |= forNewPointsTo(node, 0, shift);
 
     return changed;
 }
@@ -300,6 +349,18 @@ bool PointerAnalysis::processNode(PSNode *node) {
     bool changed = false;
     std::vector<MemoryObject *> objects;
 
+    // nodes created during the analysis (e.g., when building
+    // functions called via pointers) start tracking changes here
+    if (options.diffPropagation && !node->_delta)
+        node->_delta.reset(new PointsToDelta(&_iteration));
+    // the operands that we have taken into account
+    // (the node may get new operands during the analysis)
+    size_t operandsNum = node->getOperandsNum();
+
+    auto addPointers = [node](const PointsToSetT &S) {
+        return node->addPointsTo(S);
+    };
+
 #ifdef DEBUG_ENABLED
     size_t prev_size = node->pointsTo.size();
 #endif
@@ -336,7 +397,7 @@ bool PointerAnalysis::processNode(PSNode *node) {
         break;
     case PSNodeType::CAST:
         // cast only copies the pointers
-        changed |= node->addPointsTo(node->getOperand(0)->pointsTo);
+        changed |= forNewPointsTo(node, 0, addPointers);
         break;
     case PSNodeType::CONSTANT:
         // maybe warn? It has no sense to insert the constants into the graph.
@@ -364,8 +425,8 @@ bool PointerAnalysis::processNode(PSNode *node) {
         // gather pointers returned from subprocedure - the same way
         // as PHI works
     case PSNodeType::PHI:
-        for (PSNode *op : node->operands)
-            changed |= node->addPointsTo(op->pointsTo);
+        for (size_t i = 0; i < operandsNum; ++i)
+            changed |= forNewPointsTo(node, i, addPointers);
         break;
     case PSNodeType::CALL_FUNCPTR:
         // call via function pointer:
@@ -388,7 +449,9 @@ bool PointerAnalysis::processNode(PSNode *node) {
                 changed = true;
 
                 if (ptr.isValid() && !ptr.isInvalidated()) {
-                    functionPointerCall(node, ptr.target);
+                    if (functionPointerCall(node, ptr.target) &&
+                        _waveScheduler)
+                        _waveScheduler->invalidate();
                 } else {
                     error(node, "Calling invalid pointer as a function!");
                     continue;
@@ -409,7 +472,8 @@ bool PointerAnalysis::processNode(PSNode *node) {
                 changed = true;
 
                 if (ptr.isValid() && !ptr.isInvalidated()) {
-                    handleFork(node, ptr.target);
+                    if (handleFork(node, ptr.target) && _waveScheduler)
+                        _waveScheduler->invalidate();
                 } else {
                     error(node, "Calling invalid pointer in fork!");
                     continue;
@@ -437,6 +501,9 @@ bool PointerAnalysis::processNode(PSNode *node) {
         assert(0 && "Unknown type");
     }
 
+    if (node->_delta)
+        node->_delta->setProcessed(operandsNum);
+
 #ifdef DEBUG_ENABLED
     // the change of points-to set is not the only
     // change that can happen, so we don't use it as an
@@ -476,6 +543,146 @@ void PointerAnalysis::sanityCheck() {
 #endif // not NDEBUG
 }
 
+void PointerAnalysis::initDeltas() {
+    DBG(pta, "Using difference propagation");
+
+    for (const auto &nd : PG->getNodes()) {
+        if (nd && !nd->_delta)
+            nd->_delta.reset(new PointsToDelta(&_iteration));
+    }
+}
+
+void PointerAnalysis::releaseDeltas() {
+    for (const auto &nd : PG->getNodes()) {
+        if (nd)
+            nd->_delta.reset();
+    }
+}
+
+void PointerAnalysis::processInParallel(const std::vector<PSNode *> &nodes) {
+    const unsigned threadsNum = std::min<size_t>(
+            options.solverThreads,
+            (nodes.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+
+    // not worth spawning threads
+    if (threadsNum <= 1) {
+        for (PSNode *cur : nodes) {
+            bool enq = false;
+            enq |= beforeProcessed(cur);
+            enq |= processNode(cur);
+            enq |= afterProcessed(cur);
+
+            if (enq)
+                enqueue(cur);
+        }
+        return;
+    }
+
+    for (PSNode *cur : nodes) {
+        assert(!cur->_pending && "Node queued twice");
+        cur->_pending.reset(new PointsToSetT());
+    }
+
+    std::vector<std::vector<PSNode *>> changedBy(threadsNum);
+
+    // the threads take the nodes in chunks until all are processed
+    std::atomic<size_t> next{0};
+    auto process = [&](unsigned t) {
+        PointerIDLookupTable::Binding bind(PG->getLookupTable());
+        size_t i;
+        while ((i = next.fetch_add(PARALLEL_CHUNK)) < nodes.size()) {
+            const size_t e = std::min(i + PARALLEL_CHUNK, nodes.size());
+            for (; i < e; ++i) {
+                PSNode *cur = nodes[i];
+                bool enq = false;
+                enq |= beforeProcessed(cur);
+                enq |= processNode(cur);
+                enq |= afterProcessed(cur);
+
+                if (enq)
+                    changedBy[t].push_back(cur);
+            }
+        }
+    };
+
+    // add the pending pointers to the points-to sets,
+    // every node is committed by exactly one thread
+    auto commit = [&](unsigned t) {
+        PointerIDLookupTable::Binding bind(PG->getLookupTable());
+        for (size_t i = t; i < nodes.size(); i += threadsNum) {
+            PSNode *cur = nodes[i];
+            std::unique_ptr<PointsToSetT> pending(cur->_pending.release());
+            for (const auto &ptr : *pending)
+                cur->addPointsTo(ptr);
+        }
+    };
+
+    auto &lookupTable = PG->getLookupTable();
+    lookupTable.setConcurrent(true);
+    runInThreads(threadsNum, process);
+    runInThreads(threadsNum, commit);
+    lookupTable.setConcurrent(false);
+
+    for (auto &changedNodes : changedBy) {
+        for (PSNode *cur : changedNodes)
+            enqueue(cur);
+    }
+}
+
+bool PointerAnalysis::parallelIteration() {
+    // Split the nodes into levels. A node is in a higher level than
+    // its operands that precede it in to_process, so the nodes from
+    // one level do not depend on each other and the pointers get
+    // as far in one iteration as with the sequential processing.
+    // Nodes that cannot be processed in parallel are processed
+    // after the parallel nodes of their level.
+    const size_t N = PG->getNodes().size();
+    std::vector<unsigned> level(N, 0);
+    std::vector<bool> queued(N, false);
+    std::vector<std::vector<PSNode *>> parallel;
+    std::vector<std::vector<PSNode *>> sequential;
+
+    for (PSNode *cur : to_process) {
+        unsigned lvl = 0;
+        for (PSNode *op : cur->getOperands()) {
+            if (queued[op->getID()])
+                lvl = std::max(lvl, level[op->getID()] + 1);
+        }
+        level[cur->getID()] = lvl;
+        queued[cur->getID()] = true;
+
+        if (lvl >= parallel.size()) {
+            parallel.resize(lvl + 1);
+            sequential.resize(lvl + 1);
+        }
+
+        if (canProcessInParallel(cur))
+            parallel[lvl].push_back(cur);
+        else
+            sequential[lvl].push_back(cur);
+    }
+
+    for (size_t lvl = 0; lvl < parallel.size(); ++lvl) {
+        if (!parallel[lvl].empty()) {
+            // the sequential nodes may have changed the graph
+            prepareParallelIteration();
+            processInParallel(parallel[lvl]);
+        }
+
+        for (PSNode *cur : sequential[lvl]) {
+            bool enq = false;
+            enq |= beforeProcessed(cur);
+            enq |= processNode(cur);
+            enq |= afterProcessed(cur);
+
+            if (enq)
+                enqueue(cur);
+        }
+    }
+
+    return !changed.empty();
+}
+
 static void setToEmpty(std::vector<PSNode *> &nodes) {
     for (auto *n : nodes) {
         if (n->getType() != PSNodeType::ALLOC &&
@@ -485,13 +692,13 @@ static void setToEmpty(std::vector<PSNode *> &nodes) {
     }
 }
 
-bool PointerAnalysis::run() {
-    DBG_SECTION_BEGIN(pta, "Running pointer analysis");
-
-    preprocess();
-
-    // check that the current state of pointer analysis makes sense
-    sanityCheck();
+bool PointerAnalysis::fixpoint() {
+    // flow-sensitive analyses create their own scheduler
+    if (options.scheduler == PointerAnalysisOptions::Scheduler::WAVE &&
+        !_waveScheduler) {
+        DBG(pta, "Using wave propagation");
+        _waveScheduler.reset(new WaveScheduler(PG));
+    }
 
     // process global nodes, these must reach fixpoint after one iteration
     DBG(pta, "Processing global nodes");
@@ -511,6 +718,7 @@ bool PointerAnalysis::run() {
                          << options.maxIterations);
     }
 
+
     size_t n = 0;
     // do fixpoint
     do {
@@ -533,10 +741,30 @@ bool PointerAnalysis::run() {
     } while (!to_process.empty());
 
     DBG(pta, "Reached fixpoint after " << n << " iterations\n");
+    _fixpointIterations = n;
 
     assert(to_process.empty());
     assert(changed.empty());
 
+    return options.maxIterations > 0 ? n <= options.maxIterations : true;
+}
+
+bool PointerAnalysis::run() {
+    DBG_SECTION_BEGIN(pta, "Running pointer analysis");
+
+    // the sets created during the analysis use the table of the graph
+    PointerIDLookupTable::Binding bind(PG->getLookupTable());
+
+    preprocess();
+
+    // check that the current state of pointer analysis makes sense
+    sanityCheck();
+
+    if (options.diffPropagation)
+        initDeltas();
+
+    const bool finished = fixpoint();
+
     // NOTE: With flow-insensitive analysis, it may happen that
     // we have not reached the fixpoint here. This is beacuse
     // we queue only reachable nodes from the nodes that changed
@@ -549,9 +777,13 @@ bool PointerAnalysis::run() {
 
     sanityCheck();
 
+    // the deltas are of no use once we reached the fixpoint
+    if (options.diffPropagation)
+        releaseDeltas();
+
     DBG_SECTION_END(pta, "Running pointer analysis done");
 
-    return options.maxIterations > 0 ? n <= options.maxIterations : true;
+    return finished;
 }
 
 } // namespace pta
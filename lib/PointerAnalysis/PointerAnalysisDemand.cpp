@@ -0,0 +1,250 @@
+#include <algorithm>
+
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+// the same filter as the one used when processing the nodes
+static inline bool canBeDereferenced(const Pointer &ptr) {
+    if (!ptr.isValid() || ptr.isInvalidated() || ptr.isUnknown())
+        return false;
+
+    return ptr.target->getType() != PSNodeType::FUNCTION;
+}
+
+static inline bool readsMemory(const PSNode *n) {
+    return n->getType() == PSNodeType::LOAD ||
+           n->getType() == PSNodeType::MEMCPY;
+}
+
+static inline bool writesMemory(const PSNode *n) {
+    return n->getType() == PSNodeType::STORE ||
+           n->getType() == PSNodeType::MEMCPY;
+}
+
+// the nodes that change the graph when processed
+static inline bool changesGraph(const PSNode *n) {
+    return n->getType() == PSNodeType::CALL_FUNCPTR ||
+           n->getType() == PSNodeType::FORK ||
+           n->getType() == PSNodeType::JOIN;
+}
+
+bool PointerAnalysisDemand::addRelevant(PSNode *n) {
+    if (isRelevant(n))
+        return false;
+
+    std::vector<PSNode *> queue{n};
+    while (!queue.empty()) {
+        PSNode *cur = queue.back();
+        queue.pop_back();
+
+        if (isRelevant(cur))
+            continue;
+
+        if (cur->getID() >= _relevant.size())
+            _relevant.resize(PG->getNodes().size());
+        _relevant[cur->getID()] = true;
+        _relevantNodes.push_back(cur);
+
+        if (readsMemory(cur))
+            _readsMemory = true;
+
+        for (PSNode *op : cur->getOperands()) {
+            if (!isRelevant(op))
+                queue.push_back(op);
+        }
+    }
+
+    return true;
+}
+
+void PointerAnalysisDemand::collectReadMemory(
+        std::unordered_set<MemoryObject *> &memory) {
+    std::vector<MemoryObject *> objects;
+    for (PSNode *n : _relevantNodes) {
+        if (!readsMemory(n))
+            continue;
+
+        // LOAD reads the operand, MEMCPY the source
+        for (const Pointer &ptr : n->getOperand(0)->pointsTo) {
+            if (!canBeDereferenced(ptr))
+                continue;
+
+            objects.clear();
+            getMemoryObjects(n, ptr, objects);
+            memory.insert(objects.begin(), objects.end());
+        }
+    }
+}
+
+bool PointerAnalysisDemand::mayWrite(
+        PSNode *n, const std::unordered_set<MemoryObject *> &memory) {
+    std::vector<MemoryObject *> objects;
+    // STORE and MEMCPY write to the destination
+    for (const Pointer &ptr : n->getOperand(1)->pointsTo) {
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        objects.clear();
+        getMemoryObjects(n, ptr, objects);
+        for (MemoryObject *mo : objects) {
+            if (memory.count(mo) > 0)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// the nodes that only copy (or shift) the pointers of their operands
+static inline bool copiesPointers(const PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::GEP:
+    case PSNodeType::CAST:
+    case PSNodeType::PHI:
+    case PSNodeType::CONSTANT:
+    case PSNodeType::RETURN:
+    case PSNodeType::CALL_RETURN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// mark the nodes that get the pointers of the given nodes
+// via the nodes that copy pointers
+static void markCopies(std::vector<PSNode *> queue, std::vector<bool> &marked) {
+    while (!queue.empty()) {
+        PSNode *cur = queue.back();
+        queue.pop_back();
+
+        for (PSNode *user : cur->getUsers()) {
+            if (user->getID() >= marked.size())
+                marked.resize(user->getID() + 1);
+            if (marked[user->getID()] || !copiesPointers(user))
+                continue;
+            marked[user->getID()] = true;
+            queue.push_back(user);
+        }
+    }
+}
+
+bool PointerAnalysisDemand::addRelevantWrites() {
+    if (!_readsMemory)
+        return false;
+
+    std::unordered_set<MemoryObject *> memory;
+    collectReadMemory(memory);
+
+    // Before we compute the addresses that the stores write to,
+    // look at where the addresses come from. An address that
+    // is copied from a read object may write to it. An address that
+    // is copied only from other objects does not write to the read memory.
+    // Otherwise, the address is computed from memory (or calls)
+    // and we must compute it.
+    const auto &nodes = PG->getNodes();
+    std::vector<bool> addressesRead(nodes.size());
+    std::vector<PSNode *> queue;
+    for (MemoryObject *mo : memory) {
+        assert(mo->node && "Memory object without allocation");
+        addressesRead[mo->node->getID()] = true;
+        queue.push_back(mo->node);
+    }
+    markCopies(std::move(queue), addressesRead);
+
+    std::vector<bool> fromMemory(nodes.size());
+    queue.clear();
+    for (const auto &nd : nodes) {
+        if (nd && !copiesPointers(nd.get()) &&
+            nd->getType() != PSNodeType::ALLOC &&
+            nd->getType() != PSNodeType::FUNCTION) {
+            fromMemory[nd->getID()] = true;
+            queue.push_back(nd.get());
+        }
+    }
+    markCopies(std::move(queue), fromMemory);
+
+    bool added = false;
+    for (const auto &nd : nodes) {
+        if (!nd || isRelevant(nd.get()) || !writesMemory(nd.get()))
+            continue;
+
+        // STORE and MEMCPY write to the destination
+        PSNode *addr = nd->getOperand(1);
+        const unsigned id = addr->getID();
+        if (isRelevant(addr)) {
+            if (mayWrite(nd.get(), memory))
+                added |= addRelevant(nd.get());
+        } else if (id < addressesRead.size() && addressesRead[id]) {
+            added |= addRelevant(nd.get());
+        } else if (id < fromMemory.size() && fromMemory[id]) {
+            added |= addRelevant(addr);
+        }
+    }
+
+    return added;
+}
+
+void PointerAnalysisDemand::filterNodes(std::vector<PSNode *> &nodes) {
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(),
+                               [this](PSNode *n) { return !isRelevant(n); }),
+                nodes.end());
+}
+
+bool PointerAnalysisDemand::addNewOperands() {
+    bool added = false;
+    // the nodes that change the graph may bring new operands
+    // to the relevant nodes (and new nodes), so process all of them
+    for (const auto &nd : PG->getNodes()) {
+        if (nd && changesGraph(nd.get()))
+            added |= addRelevant(nd.get());
+    }
+
+    for (size_t i = 0; i < _relevantNodes.size(); ++i) {
+        for (PSNode *op : _relevantNodes[i]->getOperands())
+            added |= addRelevant(op);
+    }
+
+    return added;
+}
+
+bool PointerAnalysisDemand::query(PSNode *n) {
+    // the points-to sets of relevant nodes are final
+    if (isRelevant(n))
+        return true;
+
+    if (_relevantNodes.empty()) {
+        // the globals are processed always
+        for (PSNode *g : PG->getGlobals())
+            addRelevant(g);
+    }
+
+    DBG_SECTION_BEGIN(pta, "Querying the node " << n->getID());
+
+    addRelevant(n);
+    addNewOperands();
+
+    bool finished = true;
+    bool changed;
+    do {
+        finished &= run();
+        // the analysis queues only the successors of the changed nodes,
+        // so the loads that precede a changed store (and are not
+        // on a loop with it) would not see the stored pointers.
+        // Run the analysis again until the first iteration
+        // changes nothing.
+        changed = getIterationsNum() > 1;
+        // do not short-circuit, both may add nodes
+        changed |= addNewOperands() | addRelevantWrites();
+    } while (changed && finished);
+
+    DBG_SECTION_END(pta, "Querying done, relevant nodes: "
+                                 << _relevantNodes.size());
+
+    return finished;
+}
+
+} // namespace pta
+} // namespace dg
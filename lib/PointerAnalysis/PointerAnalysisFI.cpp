@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "dg/PointerAnalysis/PointerAnalysisFI.h"
+#include "dg/SCC.h"
+
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+// Does the node only copy the pointers from its operands?
+static bool isCopy(PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::CAST:
+    case PSNodeType::PHI:
+        return true;
+    case PSNodeType::GEP:
+        // GEP with 0 offset is cast
+        return PSNodeGep::get(n)->getOffset().isZero();
+    default:
+        return false;
+    }
+}
+
+namespace {
+
+///
+// The graph of copy edges (edges from the operands of copy nodes
+// to the copy nodes). We search for cycles in this graph
+// using the generic SCC algorithm. The nodes are created lazily,
+// so we build only the part of the graph that we search.
+class CopyGraph {
+  public:
+    class Node {
+        friend class CopyGraph;
+
+        CopyGraph *graph;
+        PSNode *node;
+        std::vector<Node *> _successors;
+        bool _hasSuccessors{false};
+        unsigned scc_id{0};
+
+      public:
+        Node(CopyGraph *g, PSNode *n) : graph(g), node(n) {}
+
+        PSNode *getPSNode() const { return node; }
+
+        const std::vector<Node *> &successors() {
+            if (!_hasSuccessors) {
+                for (PSNode *user : node->getUsers()) {
+                    if (isCopy(user))
+                        _successors.push_back(graph->get(user));
+                }
+                _hasSuccessors = true;
+            }
+            return _successors;
+        }
+
+        void setSCCId(unsigned id) { scc_id = id; }
+        unsigned getSCCId() const { return scc_id; }
+    };
+
+    Node *get(PSNode *n) {
+        auto &nd = _nodes[n];
+        if (!nd)
+            nd.reset(new Node(this, n));
+        return nd.get();
+    }
+
+    // create an artificial node from which are all the given nodes reachable
+    Node *createRoot(const std::vector<PSNode *> &nodes) {
+        _root.reset(new Node(this, nullptr));
+        for (PSNode *n : nodes)
+            _root->_successors.push_back(get(n));
+        _root->_hasSuccessors = true;
+        return _root.get();
+    }
+
+  private:
+    std::unordered_map<PSNode *, std::unique_ptr<Node>> _nodes;
+    std::unique_ptr<Node> _root;
+};
+
+} // anonymous namespace
+
+std::vector<PSNode *>
+PointerAnalysisFI::collapseCycles(const std::vector<PSNode *> &from) {
+    std::vector<PSNode *> representatives;
+    std::vector<PSNode *> phis;
+    for (PSNode *n : from) {
+        // every cycle of copy nodes must go through a PHI node
+        if (n->getType() == PSNodeType::PHI) {
+            searched[n] = n->getOperandsNum();
+            phis.push_back(n);
+        }
+    }
+
+    if (phis.empty())
+        return representatives;
+
+    CopyGraph graph;
+    SCC<CopyGraph::Node> scc;
+    for (auto &component : scc.compute(graph.createRoot(phis))) {
+        if (component.size() < 2)
+            continue;
+
+        std::vector<PSNode *> cycle;
+        cycle.reserve(component.size());
+        for (auto *nd : component)
+            cycle.push_back(nd->getPSNode());
+
+        representatives.push_back(collapseCycle(cycle));
+    }
+
+    return representatives;
+}
+
+PSNode *PointerAnalysisFI::collapseCycle(const std::vector<PSNode *> &cycle) {
+    // the representative is the PHI node with the lowest ID,
+    // so that it can gather the pointers from all the operands
+    PSNode *rep = nullptr;
+    for (PSNode *n : cycle) {
+        if (n->getType() == PSNodeType::PHI &&
+            (!rep || n->getID() < rep->getID()))
+            rep = n;
+    }
+    assert(rep && "A cycle of copy nodes without PHI node");
+
+    std::set<PSNode *> members(cycle.begin(), cycle.end());
+
+    // the operands that bring the pointers into the cycle
+    std::vector<PSNode *> operands;
+    for (PSNode *n : cycle) {
+        for (PSNode *op : n->getOperands()) {
+            if (members.count(op) == 0 &&
+                std::find(operands.begin(), operands.end(), op) ==
+                        operands.end())
+                operands.push_back(op);
+        }
+    }
+
+    for (PSNode *n : cycle)
+        n->removeAllOperands();
+
+    // the nodes whose operands we changed
+    std::vector<PSNode *> changedNodes(cycle.begin(), cycle.end());
+    for (PSNode *n : cycle) {
+        if (n == rep)
+            continue;
+
+        changedNodes.insert(changedNodes.end(), n->getUsers().begin(),
+                            n->getUsers().end());
+        // do not remove duplicate operands, the operands of some nodes
+        // (e.g., STORE) are not interchangeable
+        n->replaceAllUsesWith(rep, false /* remove duplicates */);
+    }
+
+    for (PSNode *op : operands)
+        rep->addOperand(op);
+
+    // the other nodes from the cycle just copy the representative,
+    // so that they have the right points-to sets in the end
+    for (PSNode *n : cycle) {
+        if (n == rep)
+            continue;
+
+        n->addOperand(rep);
+        collapsed[n] = rep;
+    }
+
+    for (PSNode *n : changedNodes) {
+        if (auto *delta = n->getDelta())
+            delta->setUnprocessed();
+    }
+
+    searched[rep] = rep->getOperandsNum();
+
+    DBG(pta, "Collapsed a cycle of " << cycle.size()
+                                     << " copy nodes into node "
+                                     << rep->getID());
+    return rep;
+}
+
+bool PointerAnalysisFI::beforeProcessed(PSNode *n) {
+    if (!options.collapseCycles)
+        return false;
+
+    auto it = collapsed.find(n);
+    if (it == collapsed.end() || n->getOperandsNum() == 1)
+        return false;
+
+    // the node got new operands during the analysis
+    // (e.g., it is a formal parameter of a function called via a pointer),
+    // move them to the representative of the cycle
+    PSNode *rep = it->second;
+    std::vector<PSNode *> operands = n->getOperands();
+    n->removeAllOperands();
+    n->addOperand(rep);
+
+    for (PSNode *op : operands) {
+        if (op != rep && op != n && !rep->hasOperand(op))
+            rep->addOperand(op);
+    }
+
+    enqueue(rep);
+    return false;
+}
+
+bool PointerAnalysisFI::afterProcessed(PSNode *n) {
+    if (!options.collapseCycles || n->getType() != PSNodeType::PHI)
+        return false;
+
+    // new copy cycles may arise only with new operands
+    auto it = searched.find(n);
+    if (it != searched.end() && it->second == n->getOperandsNum())
+        return false;
+
+    if (collapsed.count(n) > 0) {
+        searched[n] = n->getOperandsNum();
+        return false;
+    }
+
+    // the representatives must gather the pointers from their new operands
+    for (PSNode *rep : collapseCycles({n}))
+        enqueue(rep);
+
+    return false;
+}
+
+bool PointerAnalysisFI::canProcessInParallel(PSNode *n) const {
+    // these modify the graph in the hooks
+    // or track changes of operands
+    if (options.collapseCycles || options.diffPropagation)
+        return false;
+
+    switch (n->getType()) {
+    case PSNodeType::PHI:
+    case PSNodeType::CAST:
+    case PSNodeType::GEP:
+    case PSNodeType::LOAD:
+    case PSNodeType::RETURN:
+    case PSNodeType::CALL_RETURN:
+    case PSNodeType::CONSTANT:
+    case PSNodeType::ALLOC:
+    case PSNodeType::FUNCTION:
+    case PSNodeType::CALL:
+    case PSNodeType::ENTRY:
+    case PSNodeType::NOOP:
+        return true;
+    default:
+        // nodes that write to memory objects, change the graph, etc.
+        return false;
+    }
+}
+
+void PointerAnalysisFI::prepareParallelIteration() {
+    // the memory objects are created lazily in getMemoryObjects(),
+    // create them for all the allocations before loads can
+    // search for them from multiple threads
+    const auto &nodes = PG->getNodes();
+    if (preparedNodesNum == nodes.size())
+        return;
+
+    for (const auto &nd : nodes) {
+        if (!nd || nd->getType() != PSNodeType::ALLOC ||
+            nd->getData<MemoryObject>())
+            continue;
+
+        auto *mo = new MemoryObject(nd.get());
+        memory_objects.emplace_back(mo);
+        nd->setData<MemoryObject>(mo);
+    }
+
+    preparedNodesNum = nodes.size();
+}
+
+} // namespace pta
+} // namespace dg
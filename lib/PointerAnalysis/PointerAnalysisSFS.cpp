@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "dg/PointerAnalysis/PointerAnalysisSFS.h"
+
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+// the predecessors of a node in the interprocedural control flow
+// (the same that PointerAnalysisFS takes the memory maps from)
+static size_t predecessorsNum(PSNode *n) {
+    size_t num = n->predecessorsNum();
+    if (auto *CR = PSNodeCallRet::get(n))
+        num += CR->getReturns().size();
+    if (auto *E = PSNodeEntry::get(n))
+        num += E->getCallers().size();
+    return num;
+}
+
+template <typename FunT>
+static void forEachPredecessor(PSNode *n, const FunT &F) {
+    for (PSNode *p : n->predecessors())
+        F(p);
+    if (auto *CR = PSNodeCallRet::get(n)) {
+        for (PSNode *p : CR->getReturns())
+            F(p);
+    }
+    if (auto *E = PSNodeEntry::get(n)) {
+        for (PSNode *p : E->getCallers())
+            F(p);
+    }
+}
+
+static PSNode *singlePredecessor(PSNode *n) {
+    PSNode *pred = nullptr;
+    forEachPredecessor(n, [&pred](PSNode *p) {
+        assert(!pred && "The node has more predecessors");
+        pred = p;
+    });
+    return pred;
+}
+
+static bool isOnLoop(const PSNode *n) {
+    // if the scc's size > 1, the node is in loop
+    return n->getParent() ? (n->getParent()->getLoop(n) != nullptr) : false;
+}
+
+static bool pointsToAllocationInLoop(PSNode *n) {
+    for (const auto &ptr : n->pointsTo) {
+        // skip invalidated, null and unknown memory
+        if (!ptr.isValid() || ptr.isInvalidated())
+            continue;
+
+        if (isOnLoop(ptr.target))
+            return true;
+    }
+    return false;
+}
+
+static void addTargets(std::vector<PSNode *> &targets, const PointsToSetT &S) {
+    for (const auto &ptr : S) {
+        if (ptr.isValid() && !ptr.isInvalidated())
+            targets.push_back(ptr.target);
+    }
+}
+
+// the pointers to the memory that the node writes
+static const PointsToSetT *writtenPointers(PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::STORE:
+        return &n->getOperand(1)->pointsTo;
+    case PSNodeType::MEMCPY:
+        return &PSNodeMemcpy::get(n)->getDestination()->pointsTo;
+    default:
+        return nullptr;
+    }
+}
+
+void PointerAnalysisSFS::preprocess() {
+    DBG_SECTION_BEGIN(pta, "Running the flow-insensitive stage");
+    PointerAnalysisFI::preprocess();
+    fixpoint();
+    DBG_SECTION_END(pta, "The flow-insensitive stage done");
+
+    // the calls via pointers may have added new procedures
+    PG->computeLoops();
+
+    computeWrites();
+    resetPointsTo();
+    _sparse = true;
+
+    // the memory is propagated along the control flow,
+    // so let the order of nodes follow the control flow
+    if (options.scheduler == PointerAnalysisOptions::Scheduler::WAVE)
+        _waveScheduler.reset(new WaveScheduler(PG, true));
+}
+
+void PointerAnalysisSFS::computeWrites() {
+    const auto &nodes = PG->getNodes();
+    _writes.clear();
+    _writes.resize(nodes.size());
+    _global.assign(nodes.size(), false);
+    _processed.assign(nodes.size(), false);
+    _pending.assign(nodes.size(), false);
+
+    for (const auto &nd : nodes) {
+        if (!nd)
+            continue;
+
+        auto &targets = _writes[nd->getID()];
+        switch (nd->getType()) {
+        case PSNodeType::STORE:
+            addTargets(targets, nd->getOperand(1)->pointsTo);
+            break;
+        case PSNodeType::MEMCPY:
+            // the source is read in the memory state of the node
+            // as in PointerAnalysisFS, so let it have its own value
+            addTargets(targets, PSNodeMemcpy::get(nd.get())->getSource()
+                                        ->pointsTo);
+            addTargets(targets, PSNodeMemcpy::get(nd.get())->getDestination()
+                                        ->pointsTo);
+            break;
+        default:
+            break;
+        }
+
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()),
+                      targets.end());
+    }
+
+    for (PSNode *g : PG->getGlobals())
+        _global[g->getID()] = true;
+}
+
+void PointerAnalysisSFS::resetPointsTo() {
+    // forget the pointers computed by the flow-insensitive stage,
+    // keep only the pointers that the nodes have from the beginning
+    // and the called functions (the graph is built for them already)
+    for (const auto &nd : PG->getNodes()) {
+        if (!nd)
+            continue;
+
+        switch (nd->getType()) {
+        case PSNodeType::LOAD:
+        case PSNodeType::GEP:
+        case PSNodeType::CAST:
+        case PSNodeType::PHI:
+        case PSNodeType::RETURN:
+        case PSNodeType::CALL_RETURN:
+            nd->pointsTo.clear();
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void PointerAnalysisSFS::resetMemorySSA() {
+    DBG(pta, "Rebuilding the memory SSA");
+
+    const size_t nodesNum = PG->getNodes().size();
+    _writes.resize(nodesNum);
+    _global.resize(nodesNum, false);
+    _processed.resize(nodesNum, false);
+    _pending.assign(nodesNum, false);
+
+    _values.clear();
+    _valuesAt.clear();
+    _nodeValues.clear();
+    _unresolved.clear();
+    _pendingNodes.clear();
+    _rebuild = false;
+}
+
+PSNode *PointerAnalysisSFS::memoryNode(PSNode *n) const {
+    if (n->getID() < _global.size() && _global[n->getID()])
+        return PG->getEntry()->getRoot();
+    return n;
+}
+
+bool PointerAnalysisSFS::writes(PSNode *n, PSNode *target) const {
+    // the initial state of every object is defined in the root
+    if (n == PG->getEntry()->getRoot())
+        return true;
+    if (n->getID() >= _writes.size())
+        return false;
+
+    const auto &targets = _writes[n->getID()];
+    return std::binary_search(targets.begin(), targets.end(), target);
+}
+
+PointerAnalysisSFS::MemoryValue *
+PointerAnalysisSFS::createValue(PSNode *n, PSNode *target) {
+    auto *val = new MemoryValue(n, target, writes(n, target));
+    _values.emplace_back(val);
+    _valuesAt[key(n, target)] = val;
+    if (val->isDef)
+        _nodeValues[n].push_back(val);
+    _unresolved.push_back(val);
+    return val;
+}
+
+PointerAnalysisSFS::MemoryValue *PointerAnalysisSFS::getValue(PSNode *n,
+                                                              PSNode *target) {
+    // go back through the nodes that do not define the object
+    // and remember the found value for all of them
+    std::vector<PSNode *> path;
+    MemoryValue *val = nullptr;
+    PSNode *cur = n;
+    while (true) {
+        auto it = _valuesAt.find(key(cur, target));
+        if (it != _valuesAt.end()) {
+            val = it->second;
+            break;
+        }
+
+        const size_t predsNum = predecessorsNum(cur);
+        if (predsNum > 1 || writes(cur, target)) {
+            val = createValue(cur, target);
+            break;
+        }
+
+        // a cycle of nodes with single predecessors has no value,
+        // the search stops at this entry if it gets here again
+        _valuesAt.emplace(key(cur, target), nullptr);
+        path.push_back(cur);
+        if (predsNum == 0)
+            break;
+
+        cur = singlePredecessor(cur);
+    }
+
+    for (PSNode *p : path)
+        _valuesAt[key(p, target)] = val;
+
+    return val;
+}
+
+void PointerAnalysisSFS::resolveValues() {
+    std::vector<MemoryValue *> created;
+    while (!_unresolved.empty()) {
+        MemoryValue *val = _unresolved.back();
+        _unresolved.pop_back();
+        created.push_back(val);
+
+        forEachPredecessor(val->node, [&](PSNode *p) {
+            MemoryValue *input = getValue(p, val->object.node);
+            if (!input || input == val ||
+                std::find(val->inputs.begin(), val->inputs.end(), input) !=
+                        val->inputs.end())
+                return;
+
+            val->inputs.push_back(input);
+            input->users.push_back(val);
+        });
+    }
+
+    for (MemoryValue *val : created) {
+        if (mergeInputs(val))
+            propagate(val);
+    }
+}
+
+bool PointerAnalysisSFS::mergeInput(MemoryValue *val, MemoryValue *input) {
+    PSNode *n = val->node;
+    if (val->isDef) {
+        // as in PointerAnalysisFS, the node takes the memory
+        // from its predecessors only once it is processed
+        if (n->getID() >= _processed.size() || !_processed[n->getID()])
+            return false;
+    }
+
+    // every store that stores to a memory allocated
+    // not in a loop is a strong update
+    const PointsToSetT *overwritten = nullptr;
+    if (val->isDef && n->getType() == PSNodeType::STORE &&
+        !pointsToAllocationInLoop(n->getOperand(1)))
+        overwritten = &n->getOperand(1)->pointsTo;
+
+    bool changed = false;
+    for (const auto &it : input->object.pointsTo) {
+        if (overwritten &&
+            overwritten->count(Pointer(val->object.node, it.first)))
+            continue;
+
+        auto &S = val->object.pointsTo[it.first];
+        changed |= S.add(it.second);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysisSFS::mergeInputs(MemoryValue *val) {
+    bool changed = false;
+    for (MemoryValue *input : val->inputs)
+        changed |= mergeInput(val, input);
+    return changed;
+}
+
+void PointerAnalysisSFS::propagate(MemoryValue *val) {
+    std::vector<MemoryValue *> queue{val};
+    while (!queue.empty()) {
+        MemoryValue *cur = queue.back();
+        queue.pop_back();
+
+        for (PSNode *reader : cur->readers)
+            setPending(reader);
+
+        for (MemoryValue *user : cur->users) {
+            // a store merges the memory when it is processed again,
+            // so that the strong update uses its current operands
+            // (the same order of updates as in PointerAnalysisFS)
+            if (user->isDef && user->node->getType() == PSNodeType::STORE) {
+                setPending(user->node);
+                continue;
+            }
+            if (mergeInput(user, cur))
+                queue.push_back(user);
+        }
+    }
+}
+
+void PointerAnalysisSFS::setPending(PSNode *n) {
+    if (n->getID() >= _pending.size())
+        _pending.resize(PG->getNodes().size(), false);
+
+    if (_pending[n->getID()])
+        return;
+
+    _pending[n->getID()] = true;
+    _pendingNodes.push_back(n);
+}
+
+void PointerAnalysisSFS::getMemoryObjects(
+        PSNode *where, const Pointer &pointer,
+        std::vector<MemoryObject *> &objects) {
+    if (!_sparse) {
+        PointerAnalysisFI::getMemoryObjects(where, pointer, objects);
+        return;
+    }
+
+    PSNode *node = memoryNode(where);
+    PSNode *target = pointer.target;
+    if (writtenPointers(where) && !writes(node, target)) {
+        // the flow-insensitive stage did not find this write
+        // (the graph has changed), the memory SSA is not valid anymore
+        auto &targets = _writes[node->getID()];
+        targets.insert(std::upper_bound(targets.begin(), targets.end(),
+                                        target),
+                       target);
+        _valuesAt.erase(key(node, target));
+        _rebuild = true;
+    }
+
+    MemoryValue *val = getValue(node, target);
+    resolveValues();
+    if (!val)
+        return;
+
+    // stores only write the value
+    if (where->getType() != PSNodeType::STORE)
+        val->readers.insert(where);
+
+    objects.push_back(&val->object);
+}
+
+bool PointerAnalysisSFS::afterProcessed(PSNode *n) {
+    if (!_sparse)
+        return PointerAnalysisFI::afterProcessed(n);
+
+    if (n->getID() >= _processed.size())
+        _processed.resize(PG->getNodes().size(), false);
+    _processed[n->getID()] = true;
+
+    auto it = _nodeValues.find(n);
+    if (it == _nodeValues.end())
+        return false;
+
+    // merge the memory from predecessors
+    bool changed = false;
+    for (MemoryValue *val : it->second) {
+        if (mergeInputs(val)) {
+            propagate(val);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void PointerAnalysisSFS::enqueue(PSNode *n) {
+    if (_sparse) {
+        // propagate what the node has written
+        if (const auto *written = writtenPointers(n)) {
+            PSNode *node = memoryNode(n);
+            for (const auto &ptr : *written) {
+                auto it = _valuesAt.find(key(node, ptr.target));
+                if (it != _valuesAt.end() && it->second)
+                    propagate(it->second);
+            }
+        }
+    }
+
+    PointerAnalysisFI::enqueue(n);
+}
+
+bool PointerAnalysisSFS::functionPointerCall(PSNode * /*where*/,
+                                             PSNode * /*what*/) {
+    // the flow-insensitive stage has already built the called
+    // functions, if the sparse stage finds a new one, we must start
+    // building the memory SSA again
+    if (_sparse) {
+        PG->computeLoops();
+        _rebuild = true;
+    }
+    return false;
+}
+
+bool PointerAnalysisSFS::canProcessInParallel(PSNode *n) const {
+    // the memory SSA is built lazily, process the nodes
+    // of the sparse stage sequentially
+    return !_sparse && PointerAnalysisFI::canProcessInParallel(n);
+}
+
+std::vector<PSNode *>
+PointerAnalysisSFS::getNodesToProcess(const std::vector<PSNode *> &changedNodes,
+                                      size_t lastProcessedNum) {
+    if (!_sparse)
+        return PointerAnalysisFI::getNodesToProcess(changedNodes,
+                                                    lastProcessedNum);
+
+    if (_rebuild) {
+        resetMemorySSA();
+
+        // process everything again, the globals first
+        std::vector<PSNode *> nodes(PG->getGlobals().begin(),
+                                    PG->getGlobals().end());
+        auto reachable = PG->getNodes(PG->getEntry()->getRoot());
+        nodes.insert(nodes.end(), reachable.begin(), reachable.end());
+        return nodes;
+    }
+
+    // the nodes that were never processed are not reachable
+    for (PSNode *n : changedNodes) {
+        for (PSNode *user : n->getUsers()) {
+            if (user->getID() < _processed.size() &&
+                _processed[user->getID()])
+                setPending(user);
+        }
+    }
+
+    std::vector<PSNode *> nodes;
+    nodes.swap(_pendingNodes);
+    for (PSNode *n : nodes)
+        _pending[n->getID()] = false;
+
+    // the nodes were created roughly in the order of the control flow
+    std::sort(nodes.begin(), nodes.end(), [](PSNode *a, PSNode *b) {
+        return a->getID() < b->getID();
+    });
+
+    return nodes;
+}
+
+} // namespace pta
+} // namespace dg
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cassert>
+#include <mutex>
 
 #include "dg/PointerAnalysis/PSNode.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
@@ -42,11 +44,34 @@ void PointerGraph::remove(PSNode *nd) {
     nodes[nd->getID()].reset();
 }
 
+void PointerGraph::remove(PointerSubgraph *subg) {
+    auto it = std::find_if(
+            _subgraphs.begin(), _subgraphs.end(),
+            [subg](const std::unique_ptr<PointerSubgraph> &s) {
+                return s.get() == subg;
+            });
+    assert(it != _subgraphs.end() && "The subgraph is not in the graph");
+    if (_entry == subg)
+        _entry = nullptr;
+
+    _subgraphs.erase(it);
+
+    // keep the ids equal to the index in _subgraphs + 1
+    for (size_t i = 0; i < _subgraphs.size(); ++i)
+        _subgraphs[i]->_id = static_cast<unsigned>(i) + 1;
+}
+
 void PointerGraph::initStaticNodes() {
-    NULLPTR->pointsTo.clear();
-    UNKNOWN_MEMORY->pointsTo.clear();
-    NULLPTR->pointsTo.add(Pointer(NULLPTR, 0));
-    UNKNOWN_MEMORY->pointsTo.add(Pointer(UNKNOWN_MEMORY, Offset::UNKNOWN));
+    // the static nodes are shared by all graphs (that may be created
+    // in different threads) and the analyses never change them
+    // (see PointerAnalysis::sanityCheck()), initialize them just once
+    static std::once_flag initialized;
+    std::call_once(initialized, []() {
+        NULLPTR->pointsTo.clear();
+        UNKNOWN_MEMORY->pointsTo.clear();
+        NULLPTR->pointsTo.add(Pointer(NULLPTR, 0));
+        UNKNOWN_MEMORY->pointsTo.add(Pointer(UNKNOWN_MEMORY, Offset::UNKNOWN));
+    });
 }
 
 void PointerGraph::computeLoops() {
@@ -1,5 +1,10 @@
-#include "dg/PointerAnalysis/PointerGraphOptimizations.h"
+#include <algorithm>
+#include <map>
+
 #include "dg/PointerAnalysis/PointerGraph.h"
+#include "dg/PointerAnalysis/PointerGraphOptimizations.h"
+#include "dg/PointerAnalysis/WaveScheduler.h"
+#include "dg/SCC.h"
 
 namespace dg {
 namespace pta {
@@ -130,6 +135,188 @@ void PSEquivalentNodesMerger::merge(PSNode *node1, PSNode *node2) {
     ++merged_nodes_num;
 }
 
+unsigned PSPointerEquivalenceMerger::getNumber(PSNode *n) {
+    unsigned &num = numbers[n->getID()];
+    // the static nodes (e.g., unknown memory) are not numbered in run()
+    if (num == 0)
+        num = newNumber();
+    return num;
+}
+
+// the node does not write memory nor brings the state of memory
+// from other places than from its predecessor
+static bool keepsMemory(PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::LOAD:
+    case PSNodeType::GEP:
+    case PSNodeType::CAST:
+    case PSNodeType::PHI:
+    case PSNodeType::CONSTANT:
+    case PSNodeType::NOOP:
+        return true;
+    default:
+        return false;
+    }
+}
+
+unsigned PSPointerEquivalenceMerger::getMemoryVersion(PSNode *n) {
+    // go back while the state of memory is the state
+    // after the single predecessor
+    std::vector<PSNode *> chain;
+    PSNode *cur = n;
+    while (memory_versions[cur->getID()] == 0) {
+        chain.push_back(cur);
+        // mark the node as visited (a cycle of the nodes
+        // with a single predecessor is not reachable)
+        memory_versions[cur->getID()] = ~0U;
+
+        PSNode *pred = cur->getSinglePredecessorOrNull();
+        if (!pred || !keepsMemory(pred))
+            break;
+        cur = pred;
+    }
+
+    unsigned version = memory_versions[cur->getID()];
+    if (version == ~0U)
+        version = newNumber();
+    for (PSNode *nd : chain)
+        memory_versions[nd->getID()] = version;
+
+    return version;
+}
+
+unsigned PSPointerEquivalenceMerger::run() {
+    const auto &nodes = G->getNodes();
+
+    // the offsets of GEPs on loops may be set to unknown
+    // by the analysis (the preprocessGeps option),
+    // so do not merge them with the GEPs that are not on loops
+    std::vector<bool> onLoop(nodes.size(), false);
+    for (const auto &sg : G->getSubgraphs()) {
+        assert(!sg->computedLoops() &&
+               "The loops would contain the removed nodes");
+        SCC<PSNode> SCCs;
+        for (const auto &scc : SCCs.compute(sg->root)) {
+            if (scc.size() == 1 && scc[0]->getSingleSuccessorOrNull() != scc[0])
+                continue;
+            for (PSNode *nd : scc)
+                onLoop[nd->getID()] = true;
+        }
+    }
+
+    std::vector<PSNode *> all;
+    for (const auto &nd : nodes) {
+        if (nd)
+            all.push_back(nd.get());
+    }
+
+    std::vector<bool> global(nodes.size(), false);
+    for (PSNode *nd : G->getGlobals())
+        global[nd->getID()] = true;
+
+    // number the operands before their users
+    WaveScheduler order(G);
+    all = order.getNodes(all);
+
+    numbers.assign(nodes.size(), 0);
+    memory_versions.assign(nodes.size(), 0);
+    std::map<std::vector<uint64_t>, unsigned> hashed;
+    std::vector<PSNode *> representant;
+
+    for (PSNode *node : all) {
+        // the node is on a cycle of the constraint graph,
+        // its operands are not numbered yet
+        bool onCycle = false;
+        for (PSNode *op : node->getOperands()) {
+            if (nodes[op->getID()].get() == op &&
+                order.getIndex(op) == order.getIndex(node))
+                onCycle = true;
+        }
+
+        std::vector<uint64_t> key{static_cast<uint64_t>(node->getType())};
+        unsigned num = 0;
+        if (!onCycle && opaque.count(node) == 0) {
+            switch (node->getType()) {
+            case PSNodeType::CAST:
+                num = getNumber(node->getOperand(0));
+                break;
+            case PSNodeType::GEP: {
+                auto *GEP = PSNodeGep::get(node);
+                if (GEP->getOffset().isZero()) {
+                    num = getNumber(GEP->getSource());
+                } else {
+                    key.push_back(getNumber(GEP->getSource()));
+                    key.push_back(*GEP->getOffset());
+                    key.push_back(onLoop[node->getID()]);
+                }
+                break;
+            }
+            case PSNodeType::PHI: {
+                for (PSNode *op : node->getOperands())
+                    key.push_back(getNumber(op));
+                std::sort(key.begin() + 1, key.end());
+                key.erase(std::unique(key.begin() + 1, key.end()), key.end());
+                // all operands are equivalent
+                if (key.size() == 2)
+                    num = key[1];
+                else if (key.size() == 1)
+                    key.clear();
+                break;
+            }
+            case PSNodeType::CONSTANT:
+                key.push_back(getNumber(node->getOperand(0)));
+                key.push_back(*PSNodeConstant::get(node)->getOffset());
+                break;
+            case PSNodeType::LOAD:
+                key.push_back(getNumber(node->getOperand(0)));
+                key.push_back(getMemoryVersion(node));
+                break;
+            default:
+                key.clear();
+            }
+        } else {
+            key.clear();
+        }
+
+        if (num == 0) {
+            if (key.empty()) {
+                num = newNumber();
+            } else {
+                auto it = hashed.emplace(std::move(key), 0).first;
+                if (it->second == 0)
+                    it->second = newNumber();
+                num = it->second;
+            }
+        }
+
+        numbers[node->getID()] = num;
+        if (num >= representant.size())
+            representant.resize(num + 1, nullptr);
+
+        PSNode *repr = representant[num];
+        if (!repr) {
+            representant[num] = node;
+            continue;
+        }
+
+        // the global nodes are processed separately
+        // and we cannot remove a node that has a self-loop
+        const auto &succs = node->successors();
+        if (opaque.count(node) > 0 || global[node->getID()] ||
+            std::find(succs.begin(), succs.end(), node) != succs.end())
+            continue;
+
+        // keep the duplicate operands, the users may be stores
+        // or GEPs that need all of them
+        node->replaceAllUsesWith(repr, false /* removeDupl */);
+        removeNode(G, node);
+        mapping.add(node, repr);
+        ++merged_nodes_num;
+    }
+
+    return merged_nodes_num;
+}
+
 unsigned PSNoopRemover::run() {
     unsigned removed = 0;
     for (const auto &nd : G->getNodes()) {
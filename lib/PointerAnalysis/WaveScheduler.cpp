@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "dg/PointerAnalysis/WaveScheduler.h"
+
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+// iterate over successors and call (return) edges,
+// the same way as PointerGraph::getNodes() does
+template <typename FunT>
+static void forEachSuccessor(PSNode *cur, const FunT &F) {
+    if (PSNodeCall *C = PSNodeCall::get(cur)) {
+        for (auto *subg : C->getCallees())
+            F(subg->root);
+        if (!C->getCallees().empty())
+            return;
+    } else if (PSNodeRet *R = PSNodeRet::get(cur)) {
+        for (auto *ret : R->getReturnSites())
+            F(ret);
+        if (!R->getReturnSites().empty())
+            return;
+    }
+
+    for (auto *s : cur->successors())
+        F(s);
+}
+
+void WaveScheduler::computeOrder() {
+    const auto &nodes = PG->getNodes();
+    const size_t N = nodes.size();
+
+    // The roots of the search. Tarjan's algorithm finds the SCCs
+    // in the reverse topological order, so we search from the roots
+    // in the reverse BFS order. Nodes that are not constrained
+    // by each other then keep the BFS order.
+    std::vector<PSNode *> roots = PG->getNodes(PG->getEntry()->getRoot());
+    std::vector<bool> isRoot(N, false);
+    for (PSNode *n : roots)
+        isRoot[n->getID()] = true;
+    for (const auto &nd : nodes) {
+        if (nd && !isRoot[nd->getID()])
+            roots.push_back(nd.get());
+    }
+
+    // the edges of the constraint graph go from operands to their users
+    // and, if the order must follow the control flow, along the control flow
+    std::vector<std::vector<PSNode *>> edges(N);
+    for (const auto &nd : nodes) {
+        if (!nd)
+            continue;
+        auto &E = edges[nd->getID()];
+        E = nd->getUsers();
+        if (_controlFlow)
+            forEachSuccessor(nd.get(), [&E](PSNode *s) { E.push_back(s); });
+    }
+
+    // iterative Tarjan's algorithm over the constraint graph
+    // (the recursive one in dg/SCC.h would overflow the stack
+    // on the graphs of big programs)
+    std::vector<unsigned> dfsid(N, 0);
+    std::vector<unsigned> lowpt(N, 0);
+    std::vector<bool> onStack(N, false);
+    std::vector<unsigned> sccid(N, 0);
+    std::vector<PSNode *> stack;
+    std::vector<std::pair<PSNode *, size_t>> frames;
+    unsigned index = 0;
+    unsigned sccsNum = 0;
+
+    auto visit = [&](PSNode *n) {
+        dfsid[n->getID()] = lowpt[n->getID()] = ++index;
+        onStack[n->getID()] = true;
+        stack.push_back(n);
+        frames.emplace_back(n, 0);
+    };
+
+    for (auto it = roots.rbegin(), et = roots.rend(); it != et; ++it) {
+        if (dfsid[(*it)->getID()] != 0)
+            continue;
+
+        visit(*it);
+        while (!frames.empty()) {
+            PSNode *cur = frames.back().first;
+            size_t &next = frames.back().second;
+            const unsigned id = cur->getID();
+
+            if (next < edges[id].size()) {
+                PSNode *succ = edges[id][next++];
+                if (dfsid[succ->getID()] == 0) {
+                    visit(succ);
+                } else if (onStack[succ->getID()]) {
+                    lowpt[id] = std::min(lowpt[id], dfsid[succ->getID()]);
+                }
+                continue;
+            }
+
+            frames.pop_back();
+            if (!frames.empty()) {
+                const unsigned parent = frames.back().first->getID();
+                lowpt[parent] = std::min(lowpt[parent], lowpt[id]);
+            }
+
+            if (lowpt[id] == dfsid[id]) {
+                PSNode *w;
+                do {
+                    w = stack.back();
+                    stack.pop_back();
+                    onStack[w->getID()] = false;
+                    sccid[w->getID()] = sccsNum;
+                } while (w != cur);
+                ++sccsNum;
+            }
+        }
+    }
+
+    assert(stack.empty());
+
+    _order.assign(N, 0);
+    for (const auto &nd : nodes) {
+        if (nd)
+            _order[nd->getID()] = sccsNum - 1 - sccid[nd->getID()];
+    }
+
+    _queued.resize(N, 0);
+    _sccsNum = sccsNum;
+    _valid = true;
+
+    DBG(pta, "Computed topological order of " << sccsNum << " SCCs of "
+                                              << N << " nodes");
+}
+
+std::vector<PSNode *>
+WaveScheduler::getNodes(const std::vector<PSNode *> &changed,
+                        unsigned expected_num) {
+    // new nodes were created (e.g., a subgraph of a function
+    // called via a pointer)
+    if (!_valid || _order.size() != PG->getNodes().size())
+        computeOrder();
+
+    ++_wave;
+
+    std::vector<PSNode *> cont;
+    if (expected_num != 0)
+        cont.reserve(expected_num);
+
+    auto push = [&](PSNode *n) {
+        if (_queued[n->getID()] == _wave)
+            return;
+        _queued[n->getID()] = _wave;
+        cont.push_back(n);
+    };
+
+    // gather the nodes reachable from the changed nodes
+    for (PSNode *n : changed)
+        push(n);
+    for (size_t i = 0; i < cont.size(); ++i)
+        forEachSuccessor(cont[i], push);
+
+    // and order them by the topological index
+    // (the nodes from the same SCC keep the BFS order)
+    std::stable_sort(cont.begin(), cont.end(), [this](PSNode *a, PSNode *b) {
+        return getIndex(a) < getIndex(b);
+    });
+
+    return cont;
+}
+
+} // namespace pta
+} // namespace dg
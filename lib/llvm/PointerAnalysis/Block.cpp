@@ -38,6 +38,8 @@ LLVMPointerGraphBuilder::buildPointerGraphBlock(const llvm::BasicBlock &block,
             // if so, set the corresponding memory to zeroed
             if (llvm::isa<llvm::MemSetInst>(&Inst))
                 checkMemSet(&Inst);
+            else if (const auto *F = getSummarizedCallee(&Inst))
+                registerSummarizedCall(block.getParent(), F);
 
             continue;
         }
@@ -23,6 +23,10 @@ LLVMPointerGraphBuilder::createCall(const llvm::Instruction *Inst) {
         return createAsm(Inst);
     }
 
+    if (const auto *summary = getCallSummary(CInst)) {
+        return createSummarizedCall(CInst, *summary);
+    }
+
     if (const Function *func = dyn_cast<Function>(calledVal)) {
         if (func->isDeclaration()) {
             return addNode(CInst, createUndefFunctionCall(CInst, func));
@@ -32,6 +36,115 @@ LLVMPointerGraphBuilder::createCall(const llvm::Instruction *Inst) {
     return createFuncptrCall(CInst, calledVal);
 }
 
+static inline bool containsPointer(const llvm::Type *Ty) {
+    // tyContainsPointer does not look into vectors
+    return llvmutils::tyContainsPointer(Ty->getScalarType());
+}
+
+bool LLVMPointerGraphBuilder::computeIsPointerFree(const llvm::Function *F) {
+    using namespace llvm;
+
+    if (F->isVarArg())
+        return false;
+
+    for (const Argument &A : F->args()) {
+        if (containsPointer(A.getType()))
+            return false;
+    }
+
+    // the returned value must not be converted to a pointer
+    // in the caller
+    Type *retTy = F->getReturnType();
+    if (!retTy->isVoidTy() &&
+        (retTy->isAggregateType() || containsPointer(retTy) ||
+         llvmutils::typeCanBePointer(&M->getDataLayout(),
+                                     retTy->getScalarType())))
+        return false;
+
+    for (const BasicBlock &B : *F) {
+        for (const Instruction &I : B) {
+            if (isa<DbgInfoIntrinsic>(&I))
+                continue;
+
+            if (isa<PtrToIntInst>(&I) || isa<IntToPtrInst>(&I) ||
+                isa<InvokeInst>(&I) || containsPointer(I.getType()))
+                return false;
+
+            if (isa<FenceInst>(&I) && _options.threads)
+                return false;
+
+            // the called function is the only pointer that we allow
+            const Function *callee = nullptr;
+            if (const CallInst *CI = dyn_cast<CallInst>(&I)) {
+                callee = CI->getCalledFunction();
+                if (!callee)
+                    return false;
+                if (!callee->isDeclaration() && !isPointerFree(callee))
+                    return false;
+            }
+
+            for (const Value *op : I.operands()) {
+                if (op == callee)
+                    continue;
+                if (isa<ConstantExpr>(op) || containsPointer(op->getType()))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool LLVMPointerGraphBuilder::isPointerFree(const llvm::Function *F) {
+    auto it = _pointerFree.find(F);
+    if (it != _pointerFree.end())
+        return it->second;
+
+    // the functions on a recursive cycle are not pointer-free,
+    // we do not have the result for the rest of the cycle yet
+    _pointerFree[F] = false;
+    bool ret = computeIsPointerFree(F);
+    _pointerFree[F] = ret;
+    return ret;
+}
+
+const llvm::Function *
+LLVMPointerGraphBuilder::getPointerFreeCallee(const llvm::Value *val) {
+    using namespace llvm;
+
+    if (!_options.summarizePointerFree)
+        return nullptr;
+
+    const CallInst *CI = dyn_cast<CallInst>(val);
+    if (!CI || CI->isInlineAsm())
+        return nullptr;
+
+    // do not use the stripped value, the call via a bitcasted
+    // function can use the values as pointers
+    const Function *F = CI->getCalledFunction();
+    if (!F || F->isDeclaration() || !isPointerFree(F))
+        return nullptr;
+
+    return F;
+}
+
+void LLVMPointerGraphBuilder::registerSummarizedCall(
+        const llvm::Function *caller, const llvm::Function *F) {
+    PSNode *fnode = getPointsToNode(F);
+    // if we have seen the function, we registered its calls already
+    const bool known = PS.getCallGraph().get(fnode) != nullptr;
+    PS.registerCall(getPointsToNode(caller), fnode);
+    if (known)
+        return;
+
+    for (const llvm::BasicBlock &B : *F) {
+        for (const llvm::Instruction &I : B) {
+            if (const auto *callee = getSummarizedCallee(&I))
+                registerSummarizedCall(F, callee);
+        }
+    }
+}
+
 LLVMPointerGraphBuilder::PSNodesSeq
 LLVMPointerGraphBuilder::createUndefFunctionCall(const llvm::CallInst *CInst,
                                                  const llvm::Function *func) {
@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "dg/llvm/PointerAnalysis/PointerGraph.h"
+#include "dg/util/debug.h"
+
+#include "llvm/llvm-utils.h"
+
+namespace dg {
+namespace pta {
+
+// the nodes that we do not know how to clone
+// (or that change the graph during the analysis)
+static inline bool canBeCloned(const PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::CALL_FUNCPTR:
+    case PSNodeType::FORK:
+    case PSNodeType::JOIN:
+    case PSNodeType::FUNCTION:
+        return false;
+    default:
+        return true;
+    }
+}
+
+static PSNode *copyNode(PointerGraph &PS, PSNode *n) {
+    switch (n->getType()) {
+    case PSNodeType::ALLOC: {
+        auto *orig = PSNodeAlloc::cast(n);
+        auto *alloc = PSNodeAlloc::cast(PS.create<PSNodeType::ALLOC>());
+        if (orig->isZeroInitialized())
+            alloc->setZeroInitialized();
+        if (orig->isHeap())
+            alloc->setIsHeap();
+        if (orig->isGlobal())
+            alloc->setIsGlobal();
+        if (orig->isTemporary())
+            alloc->setIsTemporary();
+        return alloc;
+    }
+    case PSNodeType::LOAD:
+        return PS.create<PSNodeType::LOAD>(n->getOperand(0));
+    case PSNodeType::STORE:
+        return PS.create<PSNodeType::STORE>(n->getOperand(0),
+                                            n->getOperand(1));
+    case PSNodeType::GEP:
+        return PS.create<PSNodeType::GEP>(n->getOperand(0),
+                                          PSNodeGep::cast(n)->getOffset());
+    case PSNodeType::CAST:
+        return PS.create<PSNodeType::CAST>(n->getOperand(0));
+    case PSNodeType::FREE:
+        return PS.create<PSNodeType::FREE>(n->getOperand(0));
+    case PSNodeType::INVALIDATE_OBJECT:
+        return PS.create<PSNodeType::INVALIDATE_OBJECT>(n->getOperand(0));
+    case PSNodeType::INVALIDATE_LOCALS:
+        return PS.create<PSNodeType::INVALIDATE_LOCALS>(n->getOperand(0));
+    case PSNodeType::MEMCPY: {
+        auto *M = PSNodeMemcpy::cast(n);
+        return PS.create<PSNodeType::MEMCPY>(
+                M->getSource(), M->getDestination(), M->getLength());
+    }
+    case PSNodeType::CONSTANT:
+        return PS.create<PSNodeType::CONSTANT>(
+                n->getOperand(0), PSNodeConstant::cast(n)->getOffset());
+    case PSNodeType::PHI:
+        return PS.create<PSNodeType::PHI>();
+    case PSNodeType::CALL:
+        return PS.create<PSNodeType::CALL>();
+    case PSNodeType::CALL_RETURN:
+        return PS.create<PSNodeType::CALL_RETURN>();
+    case PSNodeType::RETURN:
+        return PS.create<PSNodeType::RETURN>();
+    case PSNodeType::NOOP:
+        return PS.create<PSNodeType::NOOP>();
+    case PSNodeType::ENTRY: {
+        auto *entry = PSNodeEntry::cast(PS.create<PSNodeType::ENTRY>());
+        entry->setFunctionName(PSNodeEntry::cast(n)->getFunctionName());
+        return entry;
+    }
+    default:
+        assert(false && "Cannot clone the node");
+        abort();
+    }
+}
+
+static void connectCall(PSNode *callNode, PointerSubgraph *subg) {
+    PSNodeCall::cast(callNode)->addCallee(subg);
+    PSNodeEntry::cast(subg->root)->addCaller(callNode);
+}
+
+static void disconnectCall(PSNode *callNode, PointerSubgraph *subg) {
+    PSNodeCall::cast(callNode)->removeCallee(subg);
+    PSNodeEntry::cast(subg->root)->removeCaller(callNode);
+}
+
+PSNode *LLVMPointerGraphBuilder::getNodeInSubgraph(const PointerSubgraph *subg,
+                                                   PSNode *nd) const {
+    auto it = _clones.find(subg);
+    if (it == _clones.end())
+        return nd;
+
+    auto nit = it->second.nodes.find(nd);
+    return nit == it->second.nodes.end() ? nd : nit->second;
+}
+
+///
+// Get the subgraphs of functions that return memory allocated
+// on heap in the function (or in a called allocation wrapper).
+std::vector<PointerSubgraph *> LLVMPointerGraphBuilder::getAllocationWrappers(
+        const std::map<PointerSubgraph *, std::vector<PSNode *>> &nodes) {
+    std::set<PointerSubgraph *> wrappers;
+    std::vector<PointerSubgraph *> candidates;
+
+    const auto *entry = M->getFunction(_options.entryFunction);
+    for (const auto &it : subgraphs_map) {
+        const llvm::Function *F = it.first;
+        PointerSubgraph *subg = it.second;
+        if (F == entry || F->isVarArg() || subg->returnNodes.empty())
+            continue;
+
+        auto nit = nodes.find(subg);
+        assert(nit != nodes.end());
+        bool cloneable = true;
+        for (PSNode *nd : nit->second) {
+            if (!canBeCloned(nd)) {
+                cloneable = false;
+                break;
+            }
+        }
+
+        if (cloneable)
+            candidates.push_back(subg);
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+              [](const PointerSubgraph *a, const PointerSubgraph *b) {
+                  return a->getID() < b->getID();
+              });
+
+    // a wrapper can return the memory allocated in another wrapper,
+    // so iterate until we find all of them
+    bool changed;
+    do {
+        changed = false;
+        for (PointerSubgraph *subg : candidates) {
+            if (wrappers.count(subg) > 0)
+                continue;
+
+            std::set<PSNode *> visited;
+            std::vector<PSNode *> queue;
+            for (PSNode *ret : subg->returnNodes) {
+                for (PSNode *op : ret->getOperands())
+                    queue.push_back(op);
+            }
+
+            bool isWrapper = false;
+            while (!queue.empty() && !isWrapper) {
+                PSNode *cur = queue.back();
+                queue.pop_back();
+
+                if (cur->getParent() != subg || !visited.insert(cur).second)
+                    continue;
+
+                switch (cur->getType()) {
+                case PSNodeType::ALLOC:
+                    isWrapper = PSNodeAlloc::cast(cur)->isHeap();
+                    break;
+                case PSNodeType::CALL_RETURN:
+                    for (auto *callee : PSNodeCall::cast(cur->getPairedNode())
+                                                ->getCallees()) {
+                        if (wrappers.count(callee) > 0)
+                            isWrapper = true;
+                    }
+                    break;
+                case PSNodeType::CAST:
+                case PSNodeType::GEP:
+                case PSNodeType::PHI:
+                    for (PSNode *op : cur->getOperands())
+                        queue.push_back(op);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            if (isWrapper) {
+                wrappers.insert(subg);
+                changed = true;
+            }
+        }
+    } while (changed);
+
+    // the candidates are sorted, keep the order
+    std::vector<PointerSubgraph *> ret;
+    ret.reserve(wrappers.size());
+    for (PointerSubgraph *subg : candidates) {
+        if (wrappers.count(subg) > 0)
+            ret.push_back(subg);
+    }
+    return ret;
+}
+
+PointerSubgraph *
+LLVMPointerGraphBuilder::cloneSubgraph(PointerSubgraph *subg,
+                                       const std::vector<PSNode *> &nodes) {
+    std::unordered_map<PSNode *, PSNode *> mapping;
+    mapping.reserve(nodes.size());
+    for (PSNode *nd : nodes) {
+        PSNode *clone = copyNode(PS, nd);
+        clone->setUserData(nd->getUserData<void>());
+        mapping[nd] = clone;
+        _clonedNodes.emplace_back(clone, nd);
+    }
+
+    auto getMapped = [&mapping](PSNode *nd) {
+        auto it = mapping.find(nd);
+        return it == mapping.end() ? nd : it->second;
+    };
+
+    PSNode *vararg = subg->vararg ? getMapped(subg->vararg) : nullptr;
+    PointerSubgraph *clone = PS.createSubgraph(getMapped(subg->root), vararg);
+    for (PSNode *ret : subg->returnNodes)
+        clone->returnNodes.insert(getMapped(ret));
+
+    for (PSNode *nd : nodes) {
+        PSNode *cloned = mapping[nd];
+        cloned->setParent(clone);
+        if (nd->getPairedNode())
+            cloned->setPairedNode(getMapped(nd->getPairedNode()));
+
+        // the constant has the pointer already (and its operands
+        // are never cloned, those are globals)
+        if (nd->getType() != PSNodeType::CONSTANT) {
+            cloned->removeAllOperands();
+            for (PSNode *op : nd->getOperands())
+                cloned->addOperand(getMapped(op));
+        }
+
+        for (PSNode *succ : nd->successors()) {
+            assert(succ->getParent() == subg && "Edge to other subgraph");
+            cloned->addSuccessor(getMapped(succ));
+        }
+    }
+
+    auto &info = _clones[clone];
+    info.nodes.swap(mapping);
+    return clone;
+}
+
+void LLVMPointerGraphBuilder::setArgumentsFromCallers(const llvm::Function *F,
+                                                      PointerSubgraph *subg) {
+    const auto &callers = PSNodeEntry::cast(subg->root)->getCallers();
+    unsigned idx = 0;
+    for (auto A = F->arg_begin(), E = F->arg_end(); A != E; ++A, ++idx) {
+        auto it = nodes_map.find(&*A);
+        if (it == nodes_map.end())
+            continue;
+
+        PSNode *arg = getNodeInSubgraph(subg, it->second.getSingleNode());
+        arg->removeAllOperands();
+        for (PSNode *callNode : callers) {
+            const auto *CI =
+                    callNode->getPairedNode()->getUserData<llvm::CallInst>();
+            assert(CI && "No call instruction for the call node");
+            PSNode *op = tryGetOperand(CI->getArgOperand(idx));
+            if (!op)
+                continue;
+            op = getNodeInSubgraph(callNode->getParent(), op);
+            if (!arg->hasOperand(op))
+                arg->addOperand(op);
+        }
+    }
+}
+
+void LLVMPointerGraphBuilder::setReturnsFromCallees(PSNode *callNode) {
+    auto *callReturn = PSNodeCallRet::cast(callNode->getPairedNode());
+    for (PSNode *ret : callReturn->getReturns())
+        PSNodeRet::get(ret)->removeReturnSite(callReturn);
+    callReturn->clearReturns();
+    callReturn->removeAllOperands();
+
+    for (PointerSubgraph *subg : PSNodeCall::cast(callNode)->getCallees()) {
+        for (PSNode *ret : subg->returnNodes)
+            addReturnNodeOperand(callNode, ret);
+    }
+}
+
+///
+// Clone the subgraphs of allocation wrappers for every call site
+// (but the first one that keeps the original subgraph). The calls
+// of allocation wrappers from the clones are cloned again until
+// the call strings have the length of _options.contextSensitivity.
+// Other called functions are shared by all contexts.
+void LLVMPointerGraphBuilder::cloneAllocationWrappers() {
+    std::map<PointerSubgraph *, std::vector<PSNode *>> nodes;
+    for (const auto &nd : PS.getNodes()) {
+        if (nd && nd->getParent())
+            nodes[nd->getParent()].push_back(nd.get());
+    }
+
+    const auto wrappers = getAllocationWrappers(nodes);
+    if (wrappers.empty())
+        return;
+
+    std::unordered_map<const PointerSubgraph *, const llvm::Function *>
+            functions;
+    for (const auto &it : subgraphs_map)
+        functions[it.second] = it.first;
+
+    // the subgraphs whose callers changed
+    std::set<PointerSubgraph *> changed;
+    // the wrappers that we are cloning (to not clone recursive calls)
+    std::vector<PointerSubgraph *> stack;
+
+    std::function<void(PSNode *, PointerSubgraph *, unsigned)> cloneForCall =
+            [&](PSNode *callNode, PointerSubgraph *subg, unsigned depth) {
+                if (std::find(stack.begin(), stack.end(), subg) != stack.end())
+                    return;
+
+                PointerSubgraph *clone = cloneSubgraph(subg, nodes[subg]);
+                _clones[clone].function = functions[subg];
+
+                disconnectCall(callNode, subg);
+                connectCall(callNode, clone);
+                setReturnsFromCallees(callNode);
+                changed.insert(subg);
+                changed.insert(clone);
+
+                stack.push_back(subg);
+                for (PSNode *nd : nodes[subg]) {
+                    if (nd->getType() != PSNodeType::CALL)
+                        continue;
+
+                    PSNode *clonedCall = getNodeInSubgraph(clone, nd);
+                    for (auto *callee : PSNodeCall::cast(nd)->getCallees()) {
+                        connectCall(clonedCall, callee);
+                        changed.insert(callee);
+                    }
+                    setReturnsFromCallees(clonedCall);
+
+                    const auto &callees = PSNodeCall::cast(nd)->getCallees();
+                    if (depth > 1 && callees.size() == 1 &&
+                        std::find(wrappers.begin(), wrappers.end(),
+                                  callees[0]) != wrappers.end())
+                        cloneForCall(clonedCall, callees[0], depth - 1);
+                }
+                stack.pop_back();
+            };
+
+    // take the call sites before cloning, the calls from the clones
+    // are handled in cloneForCall
+    std::vector<std::pair<PSNode *, PointerSubgraph *>> callSites;
+    for (PointerSubgraph *subg : wrappers) {
+        const auto &callers = PSNodeEntry::cast(subg->root)->getCallers();
+        for (size_t i = 1; i < callers.size(); ++i) {
+            assert(callers[i]->getType() == PSNodeType::CALL);
+            callSites.emplace_back(callers[i], subg);
+        }
+    }
+
+    for (auto &it : callSites)
+        cloneForCall(it.first, it.second, _options.contextSensitivity);
+
+    for (PointerSubgraph *subg : changed) {
+        auto it = _clones.find(subg);
+        setArgumentsFromCallers(it == _clones.end() ? functions[subg]
+                                                    : it->second.function,
+                                subg);
+    }
+
+    DBG(pta, "Cloned " << _clones.size() << " subgraphs of "
+                       << wrappers.size() << " allocation wrappers");
+}
+
+} // namespace pta
+} // namespace dg
@@ -0,0 +1,182 @@
+#include <cassert>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+
+#include "dg/llvm/PointerAnalysis/PointerGraph.h"
+#include "dg/util/debug.h"
+
+namespace dg {
+namespace pta {
+
+bool LLVMPointerGraphBuilder::canRebuildFunctions(
+        const std::set<const llvm::Function *> &changed) const {
+    // threads, clones and summaries connect the subgraphs
+    // also in other ways than by the call edges
+    if (threads_ || _summaries || !_clones.empty())
+        return false;
+
+    // the calls of pointer-free functions were not built,
+    // so we do not know where to connect the new subgraph
+    for (const auto *F : changed) {
+        auto it = _pointerFree.find(F);
+        if (it != _pointerFree.end() && it->second)
+            return false;
+    }
+
+    return true;
+}
+
+std::vector<PSNode *> LLVMPointerGraphBuilder::getSubgraphsNodes(
+        const std::set<const llvm::Function *> &functions) {
+    std::set<const PointerSubgraph *> subgraphs;
+    std::vector<PSNode *> ret;
+    for (const auto *F : functions) {
+        auto *subg = getSubgraph(F);
+        if (!subg)
+            continue;
+
+        subgraphs.insert(subg);
+        // the nodes inserted for calls via function pointers
+        // have no parent, but they are in the CFG of the function
+        for (PSNode *nd : PS.getNodes(subg->root, false /* interproc */)) {
+            if (!nd->getParent())
+                ret.push_back(nd);
+        }
+    }
+
+    for (const auto &nd : PS.getNodes()) {
+        if (nd && nd->getParent() && subgraphs.count(nd->getParent()) > 0)
+            ret.push_back(nd.get());
+    }
+
+    return ret;
+}
+
+void LLVMPointerGraphBuilder::rebuildFunctions(
+        const std::set<const llvm::Function *> &changed,
+        const std::set<const llvm::Function *> &removed) {
+    DBG_SECTION_BEGIN(pta, "Rebuilding " << changed.size()
+                                         << " changed functions");
+    assert(ad_hoc_building && "The graph has not been built yet");
+
+    std::set<const llvm::Function *> dirty(changed);
+    dirty.insert(removed.begin(), removed.end());
+
+    const auto &nodesVec = getSubgraphsNodes(dirty);
+    std::unordered_set<PSNode *> nodes(nodesVec.begin(), nodesVec.end());
+
+    // disconnect the subgraphs from the callers and remember
+    // the calls from the rest of the graph, we will connect
+    // the new subgraphs there
+    std::vector<std::pair<const llvm::Function *, PSNode *>> calls;
+    std::vector<PointerSubgraph *> subgraphs;
+    for (const auto *F : dirty) {
+        auto *subg = getSubgraph(F);
+        if (!subg)
+            continue;
+
+        subgraphs.push_back(subg);
+        for (PSNode *callNode : PSNodeEntry::cast(subg->root)->getCallers()) {
+            PSNodeCall::cast(callNode)->removeCallee(subg);
+            if (nodes.count(callNode) > 0)
+                continue;
+
+            if (changed.count(F) > 0) {
+                calls.emplace_back(F, callNode);
+            } else if (PSNodeCall::cast(callNode)->getCallees().empty() &&
+                       callNode->successorsNum() == 0) {
+                // a call via a pointer that could call the removed
+                // function, keep the call-return node reachable
+                callNode->addSuccessor(callNode->getPairedNode());
+            }
+        }
+    }
+
+    // remove the call and return edges to the rest of the graph
+    for (PSNode *nd : nodes) {
+        if (auto *call = PSNodeCall::get(nd)) {
+            for (auto *subg : call->getCallees())
+                PSNodeEntry::cast(subg->root)->removeCaller(nd);
+        } else if (auto *ret = PSNodeRet::get(nd)) {
+            for (auto *site : ret->getReturnSites())
+                PSNodeCallRet::cast(site)->removeReturn(nd);
+        } else if (auto *callRet = PSNodeCallRet::get(nd)) {
+            for (auto *ret : callRet->getReturns())
+                PSNodeRet::get(ret)->removeReturnSite(nd);
+        }
+    }
+
+    // now remove the nodes. The only users of the nodes that are
+    // not removed are the arguments of the called functions
+    // and the call-return nodes of the callers.
+    for (PSNode *nd : nodes)
+        nd->removeAllOperands();
+    for (PSNode *nd : nodes) {
+        nd->removeAllUses();
+        nd->removeAllEdges();
+    }
+
+    for (auto it = nodes_map.begin(); it != nodes_map.end();) {
+        if (nodes.count(it->second.getRepresentant()) > 0)
+            it = nodes_map.erase(it);
+        else
+            ++it;
+    }
+
+    for (PSNode *nd : nodes)
+        PS.remove(nd);
+    for (auto *subg : subgraphs)
+        PS.remove(subg);
+
+    for (const auto *F : dirty) {
+        // the function nodes stay in the graph (there may still be
+        // pointers to them), but the removed functions are not values
+        // in the module anymore
+        if (PSNode *fnode = getPointsToNodeOrNull(F)) {
+            if (removed.count(F) > 0) {
+                PS.getCallGraph().remove(fnode);
+                nodes_map.erase(F);
+            } else {
+                PS.getCallGraph().removeCalls(fnode);
+            }
+        }
+
+        subgraphs_map.erase(F);
+        _funcInfo.erase(F);
+        _pointerFree.erase(F);
+    }
+
+    DBG(pta, "Removed " << nodes.size() << " nodes and " << subgraphs.size()
+                        << " subgraphs");
+
+    // build the changed functions again, the functions called
+    // from the changed functions are built and connected by building
+    // the calls as when building the functions called via pointers
+    const llvm::Function *entry = M->getFunction(_options.entryFunction);
+    assert(entry && removed.count(entry) == 0 && "Removed the entry");
+    if (changed.count(entry) > 0) {
+        PS.setEntry(&createOrGetSubgraph(entry));
+        PS.getCallGraph().createNode(getPointsToNode(entry));
+    }
+
+    for (const auto &it : calls) {
+        const llvm::Function *F = it.first;
+        PSNode *callNode = it.second;
+        // the call-return node is the node of the call instruction
+        const auto *CI = callNode->getPairedNode()->getUserData<llvm::CallInst>();
+        assert(CI && "The call has no call instruction");
+
+        auto &subg = getAndConnectSubgraph(F, CI, callNode);
+        addInterproceduralOperands(F, subg, CI, callNode);
+    }
+
+    DBG_SECTION_END(pta, "Rebuilding changed functions done");
+}
+
+} // namespace pta
+} // namespace dg
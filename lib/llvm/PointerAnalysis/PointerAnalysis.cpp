@@ -1,6 +1,11 @@
+#include <set>
+#include <unordered_map>
+#include <vector>
+
 #include <llvm/IR/Instruction.h>
 
 #include "dg/llvm/PointerAnalysis/PointerAnalysis.h"
+#include "dg/util/debug.h"
 #include "llvm/llvm-utils.h"
 
 namespace dg {
@@ -110,4 +115,116 @@ LLVMPointerAnalysis::getAccessedMemory(const llvm::Instruction *I) {
     return {PTSet.hasUnknown(), regions};
 }
 
+namespace {
+
+///
+// Clear the points-to sets of the nodes that may have got pointers
+// from the given nodes and the memory objects where these pointers
+// may have been stored.
+void resetAffected(const PointerGraph *PS, const std::vector<PSNode *> &from) {
+    using pta::PSNodeType;
+
+    // the loads and memcpys reading from the memory
+    std::unordered_map<const PSNode *, std::vector<PSNode *>> readers;
+    for (const auto &nd : PS->getNodes()) {
+        if (nd && (nd->getType() == PSNodeType::LOAD ||
+                   nd->getType() == PSNodeType::MEMCPY)) {
+            for (const auto &ptr : nd->getOperand(0)->pointsTo)
+                readers[ptr.target].push_back(nd.get());
+        }
+    }
+
+    std::set<PSNode *> affected(from.begin(), from.end());
+    std::set<PSNode *> memory;
+    std::vector<PSNode *> queue(from.begin(), from.end());
+    while (!queue.empty()) {
+        PSNode *nd = queue.back();
+        queue.pop_back();
+
+        for (PSNode *user : nd->getUsers()) {
+            if (affected.insert(user).second)
+                queue.push_back(user);
+        }
+
+        if (nd->getType() != PSNodeType::STORE &&
+            nd->getType() != PSNodeType::MEMCPY)
+            continue;
+
+        for (const auto &ptr : nd->getOperand(1)->pointsTo) {
+            if (!memory.insert(ptr.target).second)
+                continue;
+            for (PSNode *reader : readers[ptr.target]) {
+                if (affected.insert(reader).second)
+                    queue.push_back(reader);
+            }
+        }
+    }
+
+    DBG(pta, "Resetting " << affected.size() << " nodes and " << memory.size()
+                          << " memory objects");
+
+    for (PSNode *nd : affected) {
+        // the functions called via the pointer are already connected,
+        // the call would be built again if we found them again
+        if (nd->getType() != PSNodeType::CALL_FUNCPTR)
+            nd->pointsTo.clear();
+    }
+
+    for (PSNode *target : memory) {
+        if (target->getType() != PSNodeType::ALLOC &&
+            target->getType() != PSNodeType::UNKNOWN_MEM)
+            continue;
+        if (auto *mo = target->getData<pta::MemoryObject>())
+            mo->pointsTo.clear();
+    }
+}
+
+} // anonymous namespace
+
+bool DGLLVMPointerAnalysis::update(
+        const std::vector<const llvm::Function *> &changed,
+        const std::vector<const llvm::Function *> &removed) {
+    const std::set<const llvm::Function *> changedSet(changed.begin(),
+                                                      changed.end());
+    const std::set<const llvm::Function *> removedSet(removed.begin(),
+                                                      removed.end());
+
+    // the other analyses (and the optimizations of the graph)
+    // keep information that we can not update
+    if (!PTA || !options.isFI() || options.mergeEquivalentNodes ||
+        options.collapseCycles || !_builder->canRebuildFunctions(changedSet)) {
+        const llvm::Module *M = _builder->getModule();
+        // the analysis uses the graph, destroy it first
+        PTA.reset();
+        _demand = nullptr;
+        PS = nullptr;
+        _builder.reset(new LLVMPointerGraphBuilder(M, options));
+        return run();
+    }
+
+    DBG_SECTION_BEGIN(pta, "Updating pointer analysis");
+
+    std::set<const llvm::Function *> dirty(changedSet);
+    dirty.insert(removedSet.begin(), removedSet.end());
+    {
+        PointerIDLookupTable::Binding bind(PS->getLookupTable());
+        resetAffected(PS, _builder->getSubgraphsNodes(dirty));
+    }
+
+    _builder->rebuildFunctions(changedSet, removedSet);
+    PTA->graphChanged();
+
+    // the solver re-processes only the nodes reachable from the nodes
+    // that changed, which is not enough when we do not start with
+    // empty points-to sets. Run it until an iteration over
+    // all nodes changes nothing.
+    bool ret;
+    do {
+        ret = PTA->run();
+    } while (ret && PTA->getIterationsNum() > 1);
+
+    DBG_SECTION_END(pta, "Updating pointer analysis done");
+    return ret;
+}
+
 } // namespace dg
@@ -93,7 +93,7 @@ PSNode *LLVMPointerGraphBuilder::tryGetOperand(const llvm::Value *val) {
 PSNode *LLVMPointerGraphBuilder::getOperand(const llvm::Value *val) {
     PSNode *op = tryGetOperand(val);
     if (!op) {
-        if (isInvalid(val, invalidate_nodes))
+        if (isInvalid(val, invalidate_nodes) || getSummarizedCallee(val))
             return UNKNOWN_MEMORY;
 
         llvm::errs() << "ERROR: missing value in graph: " << *val << "\n";
@@ -436,6 +436,8 @@ bool LLVMPointerGraphBuilder::isRelevantInstruction(
         // this one is relevant only if we analyze threads
         return _options.threads;
     case Instruction::Call:
+        if (getSummarizedCallee(&Inst))
+            return getCallSummary(&Inst) != nullptr;
         return isRelevantCall(&Inst, invalidate_nodes, _options);
     default:
         return true;
@@ -635,6 +637,14 @@ PointerGraph *LLVMPointerGraphBuilder::buildLLVMPointerGraph() {
         abort();
     }
 
+    if (_options.summaries || !_options.summaryCache.empty()) {
+        _summaries.reset(
+                new LLVMPointerSummaries(M, _options, invalidate_nodes));
+        // the file does not exist in the first run
+        if (!_options.summaryCache.empty())
+            _summaries->load(_options.summaryCache);
+    }
+
     // first we must build globals, because nodes can use them as operands
     buildGlobals();
 
@@ -655,6 +665,18 @@ PointerGraph *LLVMPointerGraphBuilder::buildLLVMPointerGraph() {
     // add root to the call graph
     PS.getCallGraph().createNode(getPointsToNode(F));
 
+    if (_summaries && !_options.summaryCache.empty() &&
+        !_summaries->save(_options.summaryCache)) {
+        llvm::errs() << "Failed writing pointer summaries to "
+                     << _options.summaryCache << "\n";
+    }
+
+    // clone the allocation wrappers for call sites
+    // (the demand-driven analysis runs on the original nodes
+    // and the threads are not supported)
+    if (_options.contextSensitivity > 0 && !_options.isDemand() && !threads_)
+        cloneAllocationWrappers();
+
 #ifndef NDEBUG
     for (const auto &subg : PS.getSubgraphs()) {
         assert(subg->root && "No root in a subgraph");
@@ -696,6 +718,23 @@ bool LLVMPointerGraphBuilder::validateSubgraph(bool no_connectivity) const {
     return true;
 }
 
+std::vector<PSNode *> LLVMPointerGraphBuilder::getArgumentNodes() {
+    std::vector<PSNode *> ret;
+    for (auto &it : subgraphs_map) {
+        const llvm::Function *F = it.first;
+        for (auto A = F->arg_begin(), E = F->arg_end(); A != E; ++A) {
+            auto nit = nodes_map.find(&*A);
+            if (nit != nodes_map.end())
+                ret.push_back(nit->second.getSingleNode());
+        }
+
+        if (it.second->vararg)
+            ret.push_back(it.second->vararg);
+    }
+
+    return ret;
+}
+
 std::vector<PSNode *>
 LLVMPointerGraphBuilder::getFunctionNodes(const llvm::Function *F) const {
     auto it = subgraphs_map.find(F);
@@ -0,0 +1,856 @@
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include "dg/llvm/PointerAnalysis/PointerGraph.h"
+#include "dg/llvm/PointerAnalysis/PointerSummaries.h"
+#include "dg/util/debug.h"
+
+#include "llvm/llvm-utils.h"
+
+namespace dg {
+namespace pta {
+
+using Path = PointerSummary::Path;
+using Step = PointerSummary::Step;
+using Paths = std::vector<Path>;
+
+// functions with bigger summaries are built as usual
+static const size_t MAX_PATHS = 8;
+static const size_t MAX_STEPS = 4;
+// bound on the number of evaluated values in one function
+static const size_t MAX_EVALUATIONS = 10000;
+
+static inline bool containsPointer(const llvm::Type *Ty) {
+    return llvmutils::tyContainsPointer(Ty->getScalarType());
+}
+
+static void addPath(Paths &paths, const Path &path) {
+    if (std::find(paths.begin(), paths.end(), path) == paths.end())
+        paths.push_back(path);
+}
+
+static void addOffset(Path &path, Offset off) {
+    if (off.isZero())
+        return;
+
+    if (!path.steps.empty() && !path.steps.back().load) {
+        path.steps.back().offset += off;
+        return;
+    }
+
+    Step step;
+    step.offset = off;
+    path.steps.push_back(step);
+}
+
+static void addLoad(Path &path) {
+    Step step;
+    step.load = true;
+    path.steps.push_back(step);
+}
+
+static bool isCopyOrShift(const llvm::Value *val) {
+    using namespace llvm;
+    return isa<PHINode>(val) || isa<SelectInst>(val) ||
+           isa<GEPOperator>(val) || isa<BitCastOperator>(val) ||
+           (isa<Operator>(val) && cast<Operator>(val)->getOpcode() ==
+                                          Instruction::AddrSpaceCast);
+}
+
+///
+// Evaluates the paths of pointer values in a function.
+// A loop can shift the pointer arbitrarily many times, so the values
+// on loops get unknown offsets. Loops that load from memory
+// (e.g., iterating over a list) are not supported.
+class PathsEvaluator {
+    LLVMPointerSummaries &_summaries;
+    const LLVMPointerAnalysisOptions &_options;
+    const llvm::DataLayout &DL;
+
+    bool _failed{false};
+    size_t _evaluations{0};
+
+    std::unordered_map<const llvm::Value *, Paths> _done;
+    // the values that are being evaluated and their depth
+    std::unordered_map<const llvm::Value *, size_t> _onStack;
+    std::vector<const llvm::Value *> _stack;
+    // the values that we have reached again while evaluating them
+    std::set<const llvm::Value *> _loopHeads;
+
+    Paths fail() {
+        _failed = true;
+        return {};
+    }
+
+    Paths evalCall(const llvm::CallInst *CI, size_t &loopDepth);
+    Paths evalValue(const llvm::Value *val, size_t &loopDepth);
+
+  public:
+    PathsEvaluator(LLVMPointerSummaries &summaries,
+                   const LLVMPointerAnalysisOptions &opts,
+                   const llvm::DataLayout &dl)
+            : _summaries(summaries), _options(opts), DL(dl) {}
+
+    bool failed() const { return _failed; }
+
+    // loopDepth is set to the depth of the lowest value on the stack
+    // that we reached again. The paths of such values are not complete
+    // until we finish the value.
+    Paths eval(const llvm::Value *val, size_t &loopDepth);
+
+    Paths eval(const llvm::Value *val) {
+        size_t loopDepth = std::numeric_limits<size_t>::max();
+        auto paths = eval(val, loopDepth);
+        assert(_failed || loopDepth == std::numeric_limits<size_t>::max());
+        return paths;
+    }
+};
+
+Paths PathsEvaluator::eval(const llvm::Value *val, size_t &loopDepth) {
+    if (_failed || ++_evaluations > MAX_EVALUATIONS)
+        return fail();
+
+    auto it = _done.find(val);
+    if (it != _done.end())
+        return it->second;
+
+    auto sit = _onStack.find(val);
+    if (sit != _onStack.end()) {
+        // we got around a loop, it must only copy and shift the pointer
+        for (size_t i = sit->second; i < _stack.size(); ++i) {
+            if (!isCopyOrShift(_stack[i]))
+                return fail();
+        }
+        _loopHeads.insert(val);
+        loopDepth = std::min(loopDepth, sit->second);
+        return {};
+    }
+
+    const size_t depth = _stack.size();
+    _stack.push_back(val);
+    _onStack[val] = depth;
+
+    size_t myLoopDepth = std::numeric_limits<size_t>::max();
+    Paths paths = evalValue(val, myLoopDepth);
+
+    _stack.pop_back();
+    _onStack.erase(val);
+
+    if (_failed)
+        return {};
+
+    // we have all the paths that enter the loop at this value,
+    // the loop can shift them by any offset
+    if (_loopHeads.erase(val) > 0) {
+        Paths widened;
+        for (auto path : paths) {
+            if (!path.steps.empty() && !path.steps.back().load) {
+                path.steps.back().offset = Offset::UNKNOWN;
+            } else {
+                Step step;
+                step.offset = Offset::UNKNOWN;
+                path.steps.push_back(step);
+            }
+            addPath(widened, path);
+        }
+        paths.swap(widened);
+    }
+
+    for (const auto &path : paths) {
+        if (path.steps.size() > MAX_STEPS)
+            return fail();
+    }
+    if (paths.size() > MAX_PATHS)
+        return fail();
+
+    if (myLoopDepth >= depth)
+        _done[val] = paths;
+    else
+        loopDepth = std::min(loopDepth, myLoopDepth);
+
+    return paths;
+}
+
+Paths PathsEvaluator::evalCall(const llvm::CallInst *CI, size_t &loopDepth) {
+    using namespace llvm;
+
+    const Function *callee = CI->getCalledFunction();
+    if (!callee)
+        return fail();
+
+    if (callee->isDeclaration()) {
+        Path path;
+        auto type = _options.getAllocationFunction(callee->getName().str());
+        if (type == AllocationFunction::NONE) {
+            // undefined functions return an unknown pointer
+            path.source = Path::Source::UNKNOWN;
+            return {path};
+        }
+
+        // the same as LLVMPointerGraphBuilder::createDynamicAlloc()
+        path.source = Path::Source::HEAP;
+        path.value = CI;
+        if (type == AllocationFunction::MALLOC) {
+            path.size = llvmutils::getConstantSizeValue(CI->getOperand(0));
+        } else if (type == AllocationFunction::CALLOC) {
+            path.zeroInitialized = true;
+            path.size = llvmutils::getConstantSizeValue(CI->getOperand(1));
+            if (path.size != 0) {
+                auto size2 =
+                        llvmutils::getConstantSizeValue(CI->getOperand(0));
+                path.size = size2 != 0 ? path.size * size2 : 0;
+            }
+        } else {
+            return fail();
+        }
+        return {path};
+    }
+
+    const PointerSummary *S = _summaries.get(callee);
+    if (!S)
+        return fail();
+
+#if LLVM_VERSION_MAJOR >= 8
+    const auto argsNum = CI->arg_size();
+#else
+    const auto argsNum = CI->getNumArgOperands();
+#endif
+
+    Paths paths;
+    for (const auto &path : S->returns) {
+        if (path.source != Path::Source::ARGUMENT) {
+            addPath(paths, path);
+            continue;
+        }
+
+        if (path.arg >= argsNum)
+            return fail();
+
+        for (auto actual : eval(CI->getArgOperand(path.arg), loopDepth)) {
+            for (const auto &step : path.steps) {
+                if (step.load)
+                    addLoad(actual);
+                else
+                    addOffset(actual, step.offset);
+            }
+            addPath(paths, actual);
+        }
+    }
+
+    return paths;
+}
+
+Paths PathsEvaluator::evalValue(const llvm::Value *val, size_t &loopDepth) {
+    using namespace llvm;
+
+    if (!val->getType()->isPointerTy())
+        return fail();
+
+    Path path;
+    if (const auto *A = dyn_cast<Argument>(val)) {
+        path.source = Path::Source::ARGUMENT;
+        path.arg = A->getArgNo();
+        return {path};
+    }
+
+    if (isa<ConstantPointerNull>(val) || llvmutils::isConstantZero(val)) {
+        path.source = Path::Source::NULLPTR;
+        return {path};
+    }
+
+    if (isa<GlobalVariable>(val) || isa<Function>(val)) {
+        path.source = Path::Source::GLOBAL;
+        path.value = val;
+        return {path};
+    }
+
+    if (isa<UndefValue>(val)) {
+        path.source = Path::Source::UNKNOWN;
+        return {path};
+    }
+
+    if (const auto *GEP = dyn_cast<GEPOperator>(val)) {
+        const Value *ptrOp = GEP->getPointerOperand();
+        unsigned bitwidth = llvmutils::getPointerBitwidth(&DL, ptrOp);
+        APInt offset(bitwidth, 0);
+        Offset off = Offset::UNKNOWN;
+        if (GEP->accumulateConstantOffset(DL, offset) && !offset.isNegative())
+            off = offset.getZExtValue();
+
+        Paths paths;
+        for (auto ptr : eval(ptrOp, loopDepth)) {
+            addOffset(ptr, off);
+            addPath(paths, ptr);
+        }
+        return paths;
+    }
+
+    if (isCopyOrShift(val) && !isa<PHINode>(val) && !isa<SelectInst>(val)) {
+        return eval(cast<Operator>(val)->getOperand(0), loopDepth);
+    }
+
+    Paths paths;
+    if (const auto *PHI = dyn_cast<PHINode>(val)) {
+        for (const Value *in : PHI->incoming_values()) {
+            for (const auto &p : eval(in, loopDepth))
+                addPath(paths, p);
+        }
+    } else if (const auto *Sel = dyn_cast<SelectInst>(val)) {
+        for (const auto &p : eval(Sel->getTrueValue(), loopDepth))
+            addPath(paths, p);
+        for (const auto &p : eval(Sel->getFalseValue(), loopDepth))
+            addPath(paths, p);
+    } else if (const auto *LI = dyn_cast<LoadInst>(val)) {
+        for (auto ptr : eval(LI->getPointerOperand(), loopDepth)) {
+            addLoad(ptr);
+            addPath(paths, ptr);
+        }
+    } else if (const auto *CI = dyn_cast<CallInst>(val)) {
+        if (CI->isInlineAsm())
+            return fail();
+        paths = evalCall(CI, loopDepth);
+    } else {
+        return fail();
+    }
+
+    return paths;
+}
+
+///
+// Can the call in a summarized function be ignored?
+// The calls of summarized functions are handled when evaluating
+// the returned value.
+static bool isCallWithoutEffects(const llvm::CallInst *CI,
+                                 LLVMPointerSummaries &summaries,
+                                 const LLVMPointerAnalysisOptions &opts,
+                                 bool invalidateNodes) {
+    using namespace llvm;
+
+    if (isa<DbgInfoIntrinsic>(CI))
+        return true;
+
+    const Function *callee = CI->getCalledFunction();
+    if (!callee || CI->isInlineAsm())
+        return false;
+
+    if (!callee->isDeclaration())
+        return summaries.get(callee) != nullptr;
+
+    if (callee->isIntrinsic()) {
+        return !isa<MemSetInst>(CI) &&
+               !isRelevantIntrinsic(callee, invalidateNodes);
+    }
+
+    auto type = opts.getAllocationFunction(callee->getName().str());
+    if (type != AllocationFunction::NONE)
+        return type == AllocationFunction::MALLOC ||
+               type == AllocationFunction::CALLOC;
+
+    // the functions that LLVMPointerGraphBuilder::createUndefFunctionCall()
+    // handles specially
+    const auto &name = callee->getName();
+    return !name.equals("free") && !name.startswith("pthread_") &&
+           !name.equals("memcpy") && !name.equals("__memcpy_chk") &&
+           !name.equals("memove") && !name.equals("memmove");
+}
+
+std::unique_ptr<PointerSummary>
+LLVMPointerSummaries::compute(const llvm::Function *F) {
+    using namespace llvm;
+
+    if (F->isDeclaration() || F->isVarArg())
+        return nullptr;
+
+    for (const Argument &A : F->args()) {
+        if (A.hasByValAttr())
+            return nullptr;
+    }
+
+    Type *retTy = F->getReturnType();
+    const bool retPointer = retTy->isPointerTy();
+    if (!retPointer && !retTy->isVoidTy() &&
+        (retTy->isAggregateType() || containsPointer(retTy) ||
+         llvmutils::typeCanBePointer(&M->getDataLayout(),
+                                     retTy->getScalarType())))
+        return nullptr;
+
+    // the function must not write to memory
+    for (const BasicBlock &B : *F) {
+        for (const Instruction &I : B) {
+            if (isa<FenceInst>(&I)) {
+                if (_options.threads)
+                    return nullptr;
+                continue;
+            }
+
+            if (isa<PtrToIntInst>(&I) || isa<IntToPtrInst>(&I))
+                return nullptr;
+
+            if (const auto *CI = dyn_cast<CallInst>(&I)) {
+                if (!isCallWithoutEffects(CI, *this, _options,
+                                          _invalidateNodes))
+                    return nullptr;
+            } else if (I.mayWriteToMemory()) {
+                return nullptr;
+            }
+        }
+    }
+
+    std::unique_ptr<PointerSummary> S(new PointerSummary());
+    if (!retPointer)
+        return S;
+
+    PathsEvaluator evaluator(*this, _options, M->getDataLayout());
+    for (const BasicBlock &B : *F) {
+        const auto *RI = dyn_cast<ReturnInst>(B.getTerminator());
+        if (!RI || !RI->getReturnValue())
+            continue;
+
+        for (const auto &path : evaluator.eval(RI->getReturnValue()))
+            addPath(S->returns, path);
+
+        if (evaluator.failed() || S->returns.size() > MAX_PATHS)
+            return nullptr;
+    }
+
+    // the function does not return, we do not have a node
+    // for the returned value
+    if (S->returns.empty())
+        return nullptr;
+
+    return S;
+}
+
+const PointerSummary *LLVMPointerSummaries::get(const llvm::Function *F) {
+    auto it = _summaries.find(F);
+    if (it != _summaries.end())
+        return it->second.get();
+
+    // the functions on a recursive cycle are not summarized,
+    // we do not have the result for the rest of the cycle yet
+    _summaries[F] = nullptr;
+
+    std::unique_ptr<PointerSummary> S;
+    if (!_options.summaryCache.empty()) {
+        const auto name = F->getName().str();
+        const auto hash = getHash(F);
+        auto cit = _cache.find(name);
+        if (cit == _cache.end() || cit->second.hash != hash ||
+            !fromString(cit->second.summary, S)) {
+            S = compute(F);
+            _cache[name] = CacheEntry{hash, toString(S.get())};
+            _cacheChanged = true;
+        }
+    } else {
+        S = compute(F);
+    }
+
+    DBG(pta, "Summary of " << F->getName().str() << ": "
+                           << (S ? toString(S.get()) : "none"));
+
+    auto *ret = S.get();
+    _summaries[F] = std::move(S);
+    return ret;
+}
+
+// FNV-1a
+static uint64_t hashString(const std::string &str,
+                           uint64_t hash = 14695981039346656037ULL) {
+    for (unsigned char c : str) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// remove the metadata and attribute group references, their numbering
+// depends on the module
+static std::string stripModuleNumbering(const std::string &str) {
+    std::string ret;
+    ret.reserve(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '!' || str[i] == '#') {
+            while (i + 1 < str.size() &&
+                   (isalnum(str[i + 1]) || str[i + 1] == '_' ||
+                    str[i + 1] == '.'))
+                ++i;
+            continue;
+        }
+        ret.push_back(str[i]);
+    }
+    return ret;
+}
+
+uint64_t LLVMPointerSummaries::getHash(const llvm::Function *F) {
+    auto it = _hashes.find(F);
+    if (it != _hashes.end())
+        return it->second;
+
+    // recursive calls
+    _hashes[F] = 0;
+
+    std::string text;
+    llvm::raw_string_ostream ostr(text);
+    ostr << M->getDataLayout().getStringRepresentation() << "\n";
+    ostr << _options.threads << _invalidateNodes << "\n";
+    F->print(ostr);
+    ostr.flush();
+
+    // the summary depends also on the summaries of the callees
+    uint64_t hash = hashString(stripModuleNumbering(text));
+    for (const llvm::BasicBlock &B : *F) {
+        for (const llvm::Instruction &I : B) {
+            const auto *CI = llvm::dyn_cast<llvm::CallInst>(&I);
+            if (!CI)
+                continue;
+            const auto *callee = CI->getCalledFunction();
+            if (callee && !callee->isDeclaration())
+                hash = hashString(std::to_string(getHash(callee)), hash);
+        }
+    }
+
+    _hashes[F] = hash;
+    return hash;
+}
+
+// the names that we can write into the file
+static bool isSimpleName(const std::string &name) {
+    return !name.empty() &&
+           std::none_of(name.begin(), name.end(), [](char c) {
+               return isspace(c) || c == '+' || c == '*' || c == ':';
+           });
+}
+
+// the allocations are stored as indices of the instructions
+static size_t getIndex(const llvm::Instruction *I) {
+    size_t idx = 0;
+    for (const llvm::BasicBlock &B : *I->getParent()->getParent()) {
+        for (const llvm::Instruction &Inst : B) {
+            if (&Inst == I)
+                return idx;
+            ++idx;
+        }
+    }
+    assert(false && "Did not find the instruction");
+    abort();
+}
+
+static const llvm::CallInst *getInstruction(const llvm::Function *F,
+                                            size_t idx) {
+    for (const llvm::BasicBlock &B : *F) {
+        for (const llvm::Instruction &I : B) {
+            if (idx-- == 0)
+                return llvm::dyn_cast<llvm::CallInst>(&I);
+        }
+    }
+    return nullptr;
+}
+
+std::string LLVMPointerSummaries::toString(const PointerSummary *S) const {
+    if (!S)
+        return "none";
+
+    std::ostringstream ostr;
+    ostr << "ret";
+    for (const auto &path : S->returns) {
+        ostr << " ";
+        switch (path.source) {
+        case Path::Source::ARGUMENT:
+            ostr << "arg" << path.arg;
+            break;
+        case Path::Source::GLOBAL: {
+            const auto name = path.value->getName().str();
+            // we can not store it, it will be computed the next time
+            if (!isSimpleName(name))
+                return "?";
+            ostr << "@" << name;
+            break;
+        }
+        case Path::Source::NULLPTR:
+            ostr << "null";
+            break;
+        case Path::Source::UNKNOWN:
+            ostr << "unknown";
+            break;
+        case Path::Source::HEAP: {
+            const auto *I = llvm::cast<llvm::Instruction>(path.value);
+            const auto *F = I->getParent()->getParent();
+            if (!isSimpleName(F->getName().str()))
+                return "?";
+            ostr << (path.zeroInitialized ? "zheap" : "heap") << path.size
+                 << ":" << F->getName().str() << ":" << getIndex(I);
+            break;
+        }
+        }
+
+        for (const auto &step : path.steps) {
+            if (step.load)
+                ostr << "*";
+            else if (step.offset.isUnknown())
+                ostr << "+?";
+            else
+                ostr << "+" << *step.offset;
+        }
+    }
+
+    return ostr.str();
+}
+
+// parse the number at pos, return its length (0 on failure)
+static size_t parseNumber(const std::string &str, size_t pos, uint64_t &num) {
+    if (pos >= str.size() || !isdigit(str[pos]))
+        return 0;
+    char *end = nullptr;
+    num = strtoull(str.c_str() + pos, &end, 10);
+    return end - (str.c_str() + pos);
+}
+
+bool LLVMPointerSummaries::fromString(
+        const std::string &str, std::unique_ptr<PointerSummary> &S) const {
+    std::istringstream istr(str);
+    std::string token;
+    if (!(istr >> token))
+        return false;
+
+    if (token == "none") {
+        S.reset();
+        return true;
+    }
+    if (token != "ret")
+        return false;
+
+    std::unique_ptr<PointerSummary> summary(new PointerSummary());
+    while (istr >> token) {
+        Path path;
+        size_t pos = std::min(token.find_first_of("+*"), token.size());
+        const auto source = token.substr(0, pos);
+        uint64_t num = 0;
+
+        if (source == "null") {
+            path.source = Path::Source::NULLPTR;
+        } else if (source == "unknown") {
+            path.source = Path::Source::UNKNOWN;
+        } else if (source.compare(0, 3, "arg") == 0 &&
+                   parseNumber(source, 3, num) == source.size() - 3) {
+            path.source = Path::Source::ARGUMENT;
+            path.arg = num;
+        } else if (source.size() > 1 && source[0] == '@') {
+            path.source = Path::Source::GLOBAL;
+            path.value = M->getNamedValue(source.substr(1));
+            if (!path.value)
+                return false;
+        } else if (source.compare(0, 4, "heap") == 0 ||
+                   source.compare(0, 5, "zheap") == 0) {
+            // heap<size>:<function>:<index of the allocation>
+            path.source = Path::Source::HEAP;
+            path.zeroInitialized = source[0] == 'z';
+            size_t len = path.zeroInitialized ? 5 : 4;
+            size_t numlen = parseNumber(source, len, num);
+            path.size = num;
+            len += numlen;
+            size_t colon = source.rfind(':');
+            if (numlen == 0 || source[len] != ':' || colon <= len)
+                return false;
+            const auto *F =
+                    M->getFunction(source.substr(len + 1, colon - len - 1));
+            if (!F || parseNumber(source, colon + 1, num) !=
+                              source.size() - colon - 1)
+                return false;
+            path.value = getInstruction(F, num);
+            if (!path.value)
+                return false;
+        } else {
+            return false;
+        }
+
+        while (pos < token.size()) {
+            Step step;
+            if (token[pos] == '*') {
+                step.load = true;
+                ++pos;
+            } else if (pos + 1 < token.size() && token[pos + 1] == '?') {
+                step.offset = Offset::UNKNOWN;
+                pos += 2;
+            } else {
+                size_t len = parseNumber(token, pos + 1, num);
+                if (len == 0)
+                    return false;
+                step.offset = num;
+                pos += len + 1;
+            }
+            path.steps.push_back(step);
+        }
+
+        summary->returns.push_back(path);
+    }
+
+    S = std::move(summary);
+    return true;
+}
+
+bool LLVMPointerSummaries::load(const std::string &path) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream istr(line);
+        CacheEntry entry;
+        std::string name;
+        if (!(istr >> std::hex >> entry.hash >> name))
+            return false;
+        std::getline(istr >> std::ws, entry.summary);
+        _cache[name] = entry;
+    }
+
+    return true;
+}
+
+bool LLVMPointerSummaries::save(const std::string &path) const {
+    if (!_cacheChanged)
+        return true;
+
+    std::ofstream ofs(path);
+    if (!ofs.is_open())
+        return false;
+
+    ofs << "# dg pointer summaries\n";
+    for (const auto &it : _cache) {
+        if (!isSimpleName(it.first) || it.second.summary == "?")
+            continue;
+        ofs << std::hex << it.second.hash << " " << it.first << " "
+            << it.second.summary << "\n";
+    }
+
+    return ofs.good();
+}
+
+const llvm::Function *
+LLVMPointerGraphBuilder::getSummarizedCallee(const llvm::Value *val) {
+    using namespace llvm;
+
+    if (const auto *F = getPointerFreeCallee(val))
+        return F;
+
+    if (!_summaries)
+        return nullptr;
+
+    const CallInst *CI = dyn_cast<CallInst>(val);
+    if (!CI || CI->isInlineAsm())
+        return nullptr;
+
+    const Function *F = CI->getCalledFunction();
+    if (!F || F->isDeclaration() || !_summaries->get(F))
+        return nullptr;
+
+    return F;
+}
+
+const PointerSummary *
+LLVMPointerGraphBuilder::getCallSummary(const llvm::Value *val) {
+    if (!_summaries)
+        return nullptr;
+
+    const auto *F = getSummarizedCallee(val);
+    if (!F)
+        return nullptr;
+
+    const auto *S = _summaries->get(F);
+    if (!S || S->returns.empty())
+        return nullptr;
+    return S;
+}
+
+LLVMPointerGraphBuilder::PSNodesSeq &
+LLVMPointerGraphBuilder::createSummarizedCall(const llvm::CallInst *CInst,
+                                              const PointerSummary &S) {
+    PSNodesSeq seq;
+    std::vector<PSNode *> returned;
+
+    for (const auto &path : S.returns) {
+        PSNode *node = nullptr;
+        switch (path.source) {
+        case Path::Source::ARGUMENT:
+            node = getOperand(CInst->getArgOperand(path.arg));
+            break;
+        case Path::Source::GLOBAL:
+            node = getOperand(path.value);
+            break;
+        case Path::Source::NULLPTR:
+            node = NULLPTR;
+            break;
+        case Path::Source::UNKNOWN:
+            node = UNKNOWN_MEMORY;
+            break;
+        case Path::Source::HEAP: {
+            // every call gets its own object
+            PSNodeAlloc *alloc =
+                    PSNodeAlloc::get(PS.create<PSNodeType::ALLOC>());
+            alloc->setIsHeap();
+            alloc->setSize(path.size);
+            if (path.zeroInitialized)
+                alloc->setZeroInitialized();
+            // the object is allocated at the same place as if we built
+            // the function
+            alloc->setUserData(const_cast<llvm::Value *>(path.value));
+            seq.append(alloc);
+            node = alloc;
+            break;
+        }
+        }
+
+        for (const auto &step : path.steps) {
+            if (step.load) {
+                node = PS.create<PSNodeType::LOAD>(node);
+            } else {
+                // the same as in createGEP()
+                Offset off = step.offset;
+                if (*_options.fieldSensitivity == 0 ||
+                    !(off < _options.fieldSensitivity))
+                    off = Offset::UNKNOWN;
+                node = PS.create<PSNodeType::GEP>(node, *off);
+            }
+            seq.append(node);
+        }
+
+        returned.push_back(node);
+    }
+
+    // the returned pointers must be in a node of this sequence
+    // (other than the allocation, it keeps its allocation site)
+    if (returned.size() > 1 || seq.empty() || seq.getLast() != returned[0] ||
+        returned[0]->getType() == PSNodeType::ALLOC) {
+        PSNode *phi = PS.create<PSNodeType::PHI>();
+        for (PSNode *nd : returned)
+            phi->addOperand(nd);
+        seq.append(phi);
+    }
+
+    registerSummarizedCall(CInst->getParent()->getParent(),
+                           CInst->getCalledFunction());
+
+    return addNode(CInst, seq);
+}
+
+} // namespace pta
+} // namespace dg
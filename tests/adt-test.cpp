@@ -182,3 +182,116 @@ TEST_CASE("TSL Hopscotch collision test", "HashMap") {
     hashCollisionTest<dg::HopscotchHashMap<MyInt, int>>();
 }
 #endif
+
+#include <random>
+#include <set>
+
+#include "dg/ADT/BDD.h"
+
+using dg::ADT::BDD;
+
+static std::set<uint64_t> bddElements(const BDD &M, BDD::NodeID n) {
+    std::set<uint64_t> ret;
+    M.enumerate(n, [&ret](uint64_t x) { ret.insert(x); });
+    return ret;
+}
+
+TEST_CASE("BDD basic operations", "BDD") {
+    BDD M(8);
+    REQUIRE(M.count(BDD::FALSE) == 0);
+    REQUIRE(M.count(BDD::TRUE) == 256);
+
+    auto A = M.singleton(3);
+    REQUIRE(M.singleton(3) == A);
+    REQUIRE(M.count(A) == 1);
+    REQUIRE(M.contains(A, 3));
+    REQUIRE(!M.contains(A, 2));
+    REQUIRE(!M.contains(A, 1000));
+
+    auto B = M.unite(A, M.singleton(200));
+    REQUIRE(M.count(B) == 2);
+    REQUIRE(bddElements(M, B) == std::set<uint64_t>{3, 200});
+    // equal sets are the same node
+    REQUIRE(M.unite(M.singleton(200), A) == B);
+    REQUIRE(M.intersect(B, A) == A);
+    REQUIRE(M.subtract(B, M.singleton(200)) == A);
+    REQUIRE(M.subtract(A, B) == BDD::FALSE);
+    REQUIRE(M.insert(A, 200) == B);
+    REQUIRE(M.insert(B, 3) == B);
+    REQUIRE(M.insert(BDD::FALSE, 3) == A);
+}
+
+TEST_CASE("BDD random operations", "BDD") {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<uint64_t> distribution(0, 3000);
+    BDD M(12);
+
+    for (int round = 0; round < 20; ++round) {
+        BDD::NodeID B1 = BDD::FALSE, B2 = BDD::FALSE;
+        std::set<uint64_t> S1, S2;
+        for (int i = 0; i < 300; ++i) {
+            auto x = distribution(generator);
+            auto y = distribution(generator);
+            B1 = M.unite(B1, M.singleton(x));
+            S1.insert(x);
+            B2 = M.insert(B2, y);
+            S2.insert(y);
+        }
+
+        REQUIRE(M.count(B1) == S1.size());
+        REQUIRE(bddElements(M, B1) == S1);
+        REQUIRE(bddElements(M, B2) == S2);
+
+        std::set<uint64_t> SI, SU = S1, SD;
+        SU.insert(S2.begin(), S2.end());
+        for (auto x : S1) {
+            if (S2.count(x) > 0)
+                SI.insert(x);
+            else
+                SD.insert(x);
+        }
+
+        auto I = M.intersect(B1, B2);
+        REQUIRE(M.count(I) == SI.size());
+        REQUIRE(bddElements(M, I) == SI);
+        auto U = M.unite(B1, B2);
+        REQUIRE(M.count(U) == SU.size());
+        REQUIRE(bddElements(M, U) == SU);
+        REQUIRE(M.unite(U, B2) == U);
+        auto D = M.subtract(B1, B2);
+        REQUIRE(bddElements(M, D) == SD);
+        REQUIRE(M.unite(D, I) == B1);
+
+        for (uint64_t x = 0; x <= 3000; x += 7)
+            REQUIRE(M.contains(U, x) == (SU.count(x) > 0));
+    }
+}
+
+#include "dg/util/cow_shared_ptr.h"
+
+TEST_CASE("Copy-on-write pointer", "cow_shared_ptr") {
+    cow_shared_ptr<std::vector<int>> A(new std::vector<int>{1, 2});
+    // not shared, modified in place
+    auto *orig = A.getWritable();
+    REQUIRE(orig == A.get());
+    orig->push_back(3);
+
+    cow_shared_ptr<std::vector<int>> B(A);
+    REQUIRE(B.get() == A.get());
+
+    // the owner must copy the shared object too
+    A.getWritable()->push_back(4);
+    REQUIRE(A.get() != B.get());
+    REQUIRE(*A.get() == std::vector<int>{1, 2, 3, 4});
+    REQUIRE(*B.get() == std::vector<int>{1, 2, 3});
+
+    // B is the only holder of the object now
+    REQUIRE(B.getWritable() == orig);
+
+    cow_shared_ptr<std::vector<int>> C;
+    C = A;
+    REQUIRE(C.get() == A.get());
+    C.getWritable()->clear();
+    REQUIRE(C->empty());
+    REQUIRE(A->size() == 4);
+}
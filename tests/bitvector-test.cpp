@@ -2,9 +2,13 @@
 
 #include <random>
 #include <set>
+#include <vector>
 
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/ChunkedBitvector.h"
 
+using dg::ADT::ChunkedBitvector;
+using dg::ADT::ChunkedBitvectorImpl;
 using dg::ADT::SparseBitvector;
 
 TEST_CASE("Querying empty set", "SparseBitvector") {
@@ -205,3 +209,97 @@ TEST_CASE("Merge random bitvectors (union)", "SparseBitvector") {
     //    B2.merge(B1);
     //    REQUIRE(B1 == B2);
 }
+
+TEST_CASE("Set and unset elements", "ChunkedBitvector") {
+    ChunkedBitvector B;
+    REQUIRE(B.empty());
+    REQUIRE(B.get(0) == false);
+    REQUIRE(B.set(0) == false);
+    REQUIRE(B.set(0) == true);
+    REQUIRE(B.set(255) == false);
+    REQUIRE(B.set(256) == false);
+    REQUIRE(B.set(~uint64_t{0}) == false);
+    REQUIRE(B.size() == 4);
+
+    std::vector<uint64_t> elems(B.begin(), B.end());
+    REQUIRE(elems == std::vector<uint64_t>{0, 255, 256, ~uint64_t{0}});
+
+    REQUIRE(B.unset(1) == false);
+    REQUIRE(B.unset(256) == true);
+    REQUIRE(B.unset(256) == false);
+    REQUIRE(B.get(256) == false);
+    REQUIRE(B.unset(0) == true);
+    REQUIRE(B.unset(255) == true);
+    REQUIRE(B.unset(~uint64_t{0}) == true);
+    REQUIRE(B.empty());
+    REQUIRE(B.begin() == B.end());
+}
+
+template <typename BitvectorT>
+static void chunkedRandomOperations(uint64_t maxValue) {
+    std::default_random_engine generator;
+    std::uniform_int_distribution<uint64_t> distribution(0, maxValue);
+
+    for (int round = 0; round < 20; ++round) {
+        BitvectorT B1, B2;
+        std::set<uint64_t> S1, S2;
+        for (int i = 0; i < 500; ++i) {
+            auto x = distribution(generator);
+            auto y = distribution(generator);
+            B1.set(x);
+            S1.insert(x);
+            B2.set(y);
+            S2.insert(y);
+        }
+
+        REQUIRE(B1.size() == S1.size());
+        REQUIRE(std::set<uint64_t>(B1.begin(), B1.end()) == S1);
+
+        bool common = false;
+        for (auto x : S1)
+            common |= S2.count(x) > 0;
+        REQUIRE(B1.intersects(B2) == common);
+
+        // intersection
+        auto I = B1;
+        std::set<uint64_t> SI;
+        for (auto x : S1) {
+            if (S2.count(x) > 0)
+                SI.insert(x);
+        }
+        REQUIRE(I.intersect(B2) == (SI != S1));
+        REQUIRE(std::set<uint64_t>(I.begin(), I.end()) == SI);
+        REQUIRE(I.isSubsetOf(B1));
+        REQUIRE(I.isSubsetOf(B2));
+
+        // union
+        auto U = B1;
+        REQUIRE(U.set(B2) == !B2.isSubsetOf(B1));
+        REQUIRE(U.set(B2) == false);
+        REQUIRE(U.set(B1) == false);
+        std::set<uint64_t> SU = S1;
+        SU.insert(S2.begin(), S2.end());
+        REQUIRE(std::set<uint64_t>(U.begin(), U.end()) == SU);
+        REQUIRE(B1.isSubsetOf(U));
+        REQUIRE(B2.isSubsetOf(U));
+        REQUIRE(U.size() == SU.size());
+
+        for (auto x : S2)
+            REQUIRE(U.unset(x) == true);
+        std::set<uint64_t> SD;
+        for (auto x : S1) {
+            if (S2.count(x) == 0)
+                SD.insert(x);
+        }
+        REQUIRE(std::set<uint64_t>(U.begin(), U.end()) == SD);
+    }
+}
+
+TEST_CASE("Random operations", "ChunkedBitvector") {
+    // dense
+    chunkedRandomOperations<ChunkedBitvector>(2000);
+    chunkedRandomOperations<ChunkedBitvectorImpl<64>>(2000);
+    chunkedRandomOperations<ChunkedBitvectorImpl<512>>(2000);
+    // sparse
+    chunkedRandomOperations<ChunkedBitvector>(~uint64_t{0});
+}
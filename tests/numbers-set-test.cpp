@@ -128,3 +128,21 @@ TEST_CASE("Iterate mixed elements", "SmallNumberSet") {
     for (auto x : S)
         REQUIRE(B.has(x));
 }
+
+TEST_CASE("Chunked number set", "BitvectorNumberSet") {
+    ChunkedBitvectorNumberSet B;
+    std::set<uint64_t> S;
+    for (uint64_t i = 0; i < 5000; i += 7) {
+        REQUIRE(B.add(i));
+        REQUIRE(!B.add(i));
+        S.insert(i);
+    }
+    REQUIRE(B.add(~uint64_t{0}));
+    S.insert(~uint64_t{0});
+
+    REQUIRE(B.size() == S.size());
+    REQUIRE(std::set<uint64_t>(B.begin(), B.end()) == S);
+    REQUIRE(B.has(0));
+    REQUIRE(!B.has(1));
+    REQUIRE(B.has(~uint64_t{0}));
+}
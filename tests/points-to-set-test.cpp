@@ -250,6 +250,9 @@ TEST_CASE("Querying empty set", "PointsToSet") {
     queryingEmptySet<SimplePointsToSet>();
     queryingEmptySet<SeparateOffsetsPointsToSet>();
     queryingEmptySet<PointerIdPointsToSet>();
+    queryingEmptySet<ChunkedPointerIdPointsToSet>();
+    queryingEmptySet<BDDPointsToSet>();
+    queryingEmptySet<SharedPointsToSet>();
     queryingEmptySet<SmallOffsetsPointsToSet>();
     queryingEmptySet<AlignedSmallOffsetsPointsToSet>();
     queryingEmptySet<AlignedPointerIdPointsToSet>();
@@ -260,6 +263,9 @@ TEST_CASE("Add an element", "PointsToSet") {
     addAnElement<SimplePointsToSet>();
     addAnElement<SeparateOffsetsPointsToSet>();
     addAnElement<PointerIdPointsToSet>();
+    addAnElement<ChunkedPointerIdPointsToSet>();
+    addAnElement<BDDPointsToSet>();
+    addAnElement<SharedPointsToSet>();
     addAnElement<SmallOffsetsPointsToSet>();
     addAnElement<AlignedSmallOffsetsPointsToSet>();
     addAnElement<AlignedPointerIdPointsToSet>();
@@ -270,6 +276,9 @@ TEST_CASE("Add few elements", "PointsToSet") {
     addFewElements<SimplePointsToSet>();
     addFewElements<SeparateOffsetsPointsToSet>();
     addFewElements<PointerIdPointsToSet>();
+    addFewElements<ChunkedPointerIdPointsToSet>();
+    addFewElements<BDDPointsToSet>();
+    addFewElements<SharedPointsToSet>();
     addFewElements<SmallOffsetsPointsToSet>();
     addFewElements<AlignedSmallOffsetsPointsToSet>();
     addFewElements<AlignedPointerIdPointsToSet>();
@@ -280,6 +289,9 @@ TEST_CASE("Add few elements 2", "PointsToSet") {
     addFewElements2<SimplePointsToSet>();
     addFewElements2<SeparateOffsetsPointsToSet>();
     addFewElements2<PointerIdPointsToSet>();
+    addFewElements2<ChunkedPointerIdPointsToSet>();
+    addFewElements2<BDDPointsToSet>();
+    addFewElements2<SharedPointsToSet>();
     addFewElements2<SmallOffsetsPointsToSet>();
     addFewElements2<AlignedSmallOffsetsPointsToSet>();
     addFewElements2<AlignedPointerIdPointsToSet>();
@@ -290,6 +302,9 @@ TEST_CASE("Merge points-to sets", "PointsToSet") {
     mergePointsToSets<SimplePointsToSet>();
     mergePointsToSets<SeparateOffsetsPointsToSet>();
     mergePointsToSets<PointerIdPointsToSet>();
+    mergePointsToSets<ChunkedPointerIdPointsToSet>();
+    mergePointsToSets<BDDPointsToSet>();
+    mergePointsToSets<SharedPointsToSet>();
     mergePointsToSets<SmallOffsetsPointsToSet>();
     mergePointsToSets<AlignedSmallOffsetsPointsToSet>();
     mergePointsToSets<AlignedPointerIdPointsToSet>();
@@ -301,6 +316,9 @@ TEST_CASE("Remove element",
     removeElement<OffsetsSetPointsToSet>();
     removeElement<SimplePointsToSet>();
     removeElement<PointerIdPointsToSet>();
+    removeElement<ChunkedPointerIdPointsToSet>();
+    removeElement<BDDPointsToSet>();
+    removeElement<SharedPointsToSet>();
     removeElement<SmallOffsetsPointsToSet>();
     removeElement<AlignedSmallOffsetsPointsToSet>();
     removeElement<AlignedPointerIdPointsToSet>();
@@ -312,6 +330,9 @@ TEST_CASE("Remove few elements",
     removeFewElements<OffsetsSetPointsToSet>();
     removeFewElements<SimplePointsToSet>();
     removeFewElements<PointerIdPointsToSet>();
+    removeFewElements<ChunkedPointerIdPointsToSet>();
+    removeFewElements<BDDPointsToSet>();
+    removeFewElements<SharedPointsToSet>();
     removeFewElements<SmallOffsetsPointsToSet>();
     removeFewElements<AlignedSmallOffsetsPointsToSet>();
     removeFewElements<AlignedPointerIdPointsToSet>();
@@ -323,6 +344,9 @@ TEST_CASE("Remove all elements pointing to a target",
     removeAnyTest<OffsetsSetPointsToSet>();
     removeAnyTest<SimplePointsToSet>();
     removeAnyTest<PointerIdPointsToSet>();
+    removeAnyTest<ChunkedPointerIdPointsToSet>();
+    removeAnyTest<BDDPointsToSet>();
+    removeAnyTest<SharedPointsToSet>();
     removeAnyTest<SmallOffsetsPointsToSet>();
     removeAnyTest<AlignedSmallOffsetsPointsToSet>();
     removeAnyTest<AlignedPointerIdPointsToSet>();
@@ -333,6 +357,9 @@ TEST_CASE("Test various points-to functions", "PointsToSet") {
     pointsToTest<SimplePointsToSet>();
     pointsToTest<SeparateOffsetsPointsToSet>();
     pointsToTest<PointerIdPointsToSet>();
+    pointsToTest<ChunkedPointerIdPointsToSet>();
+    pointsToTest<BDDPointsToSet>();
+    pointsToTest<SharedPointsToSet>();
     pointsToTest<SmallOffsetsPointsToSet>();
     pointsToTest<AlignedSmallOffsetsPointsToSet>();
     pointsToTest<AlignedPointerIdPointsToSet>();
@@ -346,3 +373,97 @@ TEST_CASE("Test aligned overflow set behavior", "PointsToSet") {
     testAlignedOverflowBehavior<AlignedSmallOffsetsPointsToSet>();
     testAlignedOverflowBehavior<AlignedPointerIdPointsToSet>();
 }
+
+TEST_CASE("Shared points-to sets", "PointsToSet") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+
+    SharedPointsToSet S1, S2, S3;
+    S1.add(Pointer(A, 0));
+    S1.add(Pointer(B, 8));
+    // added in a different order
+    S2.add(Pointer(B, 8));
+    S2.add(Pointer(A, 0));
+    REQUIRE(S1.sharesWith(S2));
+    REQUIRE(!S1.sharesWith(S3));
+
+    // the union is one of the sets
+    S3.add(Pointer(A, 0));
+    REQUIRE(S1.add(S3) == false);
+    REQUIRE(S3.add(S1) == true);
+    REQUIRE(S3.sharesWith(S1));
+
+    // sets from another graph
+    PointerGraph PS2;
+    SharedPointsToSet S4;
+    {
+        dg::PointerIDLookupTable::Binding bind(PS2.getLookupTable());
+        SharedPointsToSet S5;
+        S5.add(Pointer(A, 0));
+        S5.add(Pointer(B, 16));
+        REQUIRE(&S5.getLookupTable() == &PS2.getLookupTable());
+        REQUIRE(S4.add(S5) == true);
+    }
+    REQUIRE(S4.size() == 2);
+    REQUIRE(S4.pointsTo(Pointer(B, 16)));
+    REQUIRE(&S4.getLookupTable() != &PS2.getLookupTable());
+
+    // removing gives the shared set again
+    S2.add(Pointer(B, 16));
+    REQUIRE(!S2.sharesWith(S1));
+    REQUIRE(S2.remove(Pointer(B, 16)) == true);
+    REQUIRE(S2.sharesWith(S1));
+
+    REQUIRE(S1.add(Pointer(A, dg::Offset::UNKNOWN)) == true);
+    REQUIRE(S1.size() == 2);
+    REQUIRE(S1.add(Pointer(A, 8)) == false);
+    REQUIRE(S1.removeAny(A) == true);
+    REQUIRE(S1.size() == 1);
+}
+
+TEST_CASE("BDD points-to sets", "PointsToSet") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+
+    BDDPointsToSet S1, S2, S3;
+    S1.add(Pointer(A, 0));
+    S1.add(Pointer(B, 8));
+    // added in a different order
+    S2.add(Pointer(B, 8));
+    S2.add(Pointer(A, 0));
+    REQUIRE(S1.sharesWith(S2));
+    REQUIRE(!S1.sharesWith(S3));
+
+    S3.add(Pointer(A, 0));
+    REQUIRE(S1.add(S3) == false);
+    REQUIRE(S3.add(S1) == true);
+    REQUIRE(S3.sharesWith(S1));
+
+    // sets from another graph
+    PointerGraph PS2;
+    BDDPointsToSet S4;
+    {
+        dg::PointerIDLookupTable::Binding bind(PS2.getLookupTable());
+        BDDPointsToSet S5;
+        S5.add(Pointer(A, 0));
+        S5.add(Pointer(B, 16));
+        REQUIRE(&S5.getLookupTable() == &PS2.getLookupTable());
+        REQUIRE(S4.add(S5) == true);
+    }
+    REQUIRE(S4.size() == 2);
+    REQUIRE(S4.pointsTo(Pointer(B, 16)));
+
+    S2.add(Pointer(B, 16));
+    REQUIRE(!S2.sharesWith(S1));
+    REQUIRE(S2.remove(Pointer(B, 16)) == true);
+    REQUIRE(S2.sharesWith(S1));
+
+    REQUIRE(S1.add(Pointer(A, dg::Offset::UNKNOWN)) == true);
+    REQUIRE(S1.size() == 2);
+    REQUIRE(S1.add(Pointer(A, 8)) == false);
+    REQUIRE(S1.removeAny(A) == true);
+    REQUIRE(S1.size() == 1);
+    REQUIRE(S1.pointsTo(Pointer(B, 8)));
+}
@@ -1,8 +1,18 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
+#include "dg/PointerAnalysis/PointerAnalysisDemand.h"
 #include "dg/PointerAnalysis/PointerAnalysisFI.h"
 #include "dg/PointerAnalysis/PointerAnalysisFS.h"
+#include "dg/PointerAnalysis/PointerAnalysisSFS.h"
 #include "dg/PointerAnalysis/PointerGraph.h"
+#include "dg/PointerAnalysis/PointerGraphOptimizations.h"
 
 using namespace dg::pta;
 using dg::Offset;
@@ -868,6 +878,117 @@ void memcpy_test8() {
     REQUIRE(L3->doesPointsTo(NULLPTR));
 }
 
+template <typename PTStoT>
+void phi_loop() {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *C = PS.create<PSNodeType::ALLOC>();
+    PSNode *L = PS.create<PSNodeType::LOAD>(B);
+    PSNode *X = PS.create<PSNodeType::PHI>(A, L);
+    PSNode *Y = PS.create<PSNodeType::CAST>(X);
+    PSNode *S1 = PS.create<PSNodeType::STORE>(Y, B);
+    PSNode *S2 = PS.create<PSNodeType::STORE>(C, B);
+
+    /* the pointer to C gets to X only via the loop
+     *     A -> B -> C -> X -> Y -> S1 -> L -> S2
+     *                    ^                    |
+     *                    +--------------------+
+     */
+    A->addSuccessor(B);
+    B->addSuccessor(C);
+    C->addSuccessor(X);
+    X->addSuccessor(Y);
+    Y->addSuccessor(S1);
+    S1->addSuccessor(L);
+    L->addSuccessor(S2);
+    S2->addSuccessor(X);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+    PTStoT PA(&PS);
+    PA.run();
+
+    REQUIRE(L->doesPointsTo(A));
+    REQUIRE(L->doesPointsTo(C));
+    REQUIRE(X->doesPointsTo(A));
+    REQUIRE(X->doesPointsTo(C));
+    REQUIRE(Y->doesPointsTo(C));
+    REQUIRE(Y->pointsTo.size() == 2);
+}
+
+template <typename PTStoT>
+void copy_cycle() {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *X = PS.create<PSNodeType::PHI>(A);
+    PSNode *Y = PS.create<PSNodeType::CAST>(X);
+    PSNode *Z = PS.create<PSNodeType::CAST>(Y);
+    PSNode *W = PS.create<PSNodeType::PHI>(Z, B);
+    PSNode *U = PS.create<PSNodeType::CAST>(Y);
+    X->addOperand(W);
+
+    /* X, Y, Z and W form a cycle of copy nodes
+     *     A -> B -> X -> Y -> Z -> W -> U
+     *               ^              |
+     *               +--------------+
+     */
+    A->addSuccessor(B);
+    B->addSuccessor(X);
+    X->addSuccessor(Y);
+    Y->addSuccessor(Z);
+    Z->addSuccessor(W);
+    W->addSuccessor(X);
+    W->addSuccessor(U);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+    PTStoT PA(&PS);
+    PA.run();
+
+    for (PSNode *n : {X, Y, Z, W, U}) {
+        REQUIRE(n->doesPointsTo(A));
+        REQUIRE(n->doesPointsTo(B));
+        REQUIRE(n->pointsTo.size() == 2);
+    }
+}
+
+// flow-insensitive analysis with difference propagation
+class PointerAnalysisFIDiff : public dg::pta::PointerAnalysisFI {
+  public:
+    PointerAnalysisFIDiff(PointerGraph *ps)
+            : PointerAnalysisFI(
+                      ps,
+                      dg::PointerAnalysisOptions().setDiffPropagation(true)) {}
+};
+
+// flow-insensitive analysis that collapses cycles of copy nodes
+class PointerAnalysisFICollapse : public dg::pta::PointerAnalysisFI {
+  public:
+    PointerAnalysisFICollapse(PointerGraph *ps)
+            : PointerAnalysisFI(
+                      ps, dg::PointerAnalysisOptions().setCollapseCycles(true)) {}
+};
+
+// flow-insensitive analysis with wave propagation
+class PointerAnalysisFIWave : public dg::pta::PointerAnalysisFI {
+  public:
+    PointerAnalysisFIWave(PointerGraph *ps)
+            : PointerAnalysisFI(ps, dg::PointerAnalysisOptions().setScheduler(
+                                            dg::PointerAnalysisOptions::
+                                                    Scheduler::WAVE)) {}
+};
+
+// flow-sensitive analysis with wave propagation
+class PointerAnalysisFSWave : public dg::pta::PointerAnalysisFS {
+  public:
+    PointerAnalysisFSWave(PointerGraph *ps)
+            : PointerAnalysisFS(ps, dg::PointerAnalysisOptions().setScheduler(
+                                            dg::PointerAnalysisOptions::
+                                                    Scheduler::WAVE)) {}
+};
+
 TEST_CASE("Flow insensitive", "FI") {
     store_load<dg::pta::PointerAnalysisFI>();
     store_load2<dg::pta::PointerAnalysisFI>();
@@ -893,6 +1014,390 @@ TEST_CASE("Flow insensitive", "FI") {
     memcpy_test6<dg::pta::PointerAnalysisFI>();
     memcpy_test7<dg::pta::PointerAnalysisFI>();
     memcpy_test8<dg::pta::PointerAnalysisFI>();
+    phi_loop<dg::pta::PointerAnalysisFI>();
+    copy_cycle<dg::pta::PointerAnalysisFI>();
+}
+
+TEST_CASE("Flow insensitive with difference propagation", "FI") {
+    store_load<PointerAnalysisFIDiff>();
+    store_load2<PointerAnalysisFIDiff>();
+    store_load3<PointerAnalysisFIDiff>();
+    store_load4<PointerAnalysisFIDiff>();
+    store_load5<PointerAnalysisFIDiff>();
+    gep1<PointerAnalysisFIDiff>();
+    gep2<PointerAnalysisFIDiff>();
+    gep3<PointerAnalysisFIDiff>();
+    gep4<PointerAnalysisFIDiff>();
+    gep5<PointerAnalysisFIDiff>();
+    nulltest<PointerAnalysisFIDiff>();
+    constant_store<PointerAnalysisFIDiff>();
+    load_from_zeroed<PointerAnalysisFIDiff>();
+    load_from_unknown_offset<PointerAnalysisFIDiff>();
+    load_from_unknown_offset2<PointerAnalysisFIDiff>();
+    load_from_unknown_offset3<PointerAnalysisFIDiff>();
+    memcpy_test<PointerAnalysisFIDiff>();
+    memcpy_test2<PointerAnalysisFIDiff>();
+    memcpy_test3<PointerAnalysisFIDiff>();
+    memcpy_test4<PointerAnalysisFIDiff>();
+    memcpy_test5<PointerAnalysisFIDiff>();
+    memcpy_test6<PointerAnalysisFIDiff>();
+    memcpy_test7<PointerAnalysisFIDiff>();
+    memcpy_test8<PointerAnalysisFIDiff>();
+    phi_loop<PointerAnalysisFIDiff>();
+    copy_cycle<PointerAnalysisFIDiff>();
+}
+
+TEST_CASE("Flow insensitive with collapsing of copy cycles", "FI") {
+    store_load<PointerAnalysisFICollapse>();
+    store_load2<PointerAnalysisFICollapse>();
+    store_load3<PointerAnalysisFICollapse>();
+    store_load4<PointerAnalysisFICollapse>();
+    store_load5<PointerAnalysisFICollapse>();
+    gep1<PointerAnalysisFICollapse>();
+    gep2<PointerAnalysisFICollapse>();
+    gep3<PointerAnalysisFICollapse>();
+    gep4<PointerAnalysisFICollapse>();
+    gep5<PointerAnalysisFICollapse>();
+    nulltest<PointerAnalysisFICollapse>();
+    constant_store<PointerAnalysisFICollapse>();
+    load_from_zeroed<PointerAnalysisFICollapse>();
+    load_from_unknown_offset<PointerAnalysisFICollapse>();
+    load_from_unknown_offset2<PointerAnalysisFICollapse>();
+    load_from_unknown_offset3<PointerAnalysisFICollapse>();
+    memcpy_test<PointerAnalysisFICollapse>();
+    memcpy_test2<PointerAnalysisFICollapse>();
+    memcpy_test3<PointerAnalysisFICollapse>();
+    memcpy_test4<PointerAnalysisFICollapse>();
+    memcpy_test5<PointerAnalysisFICollapse>();
+    memcpy_test6<PointerAnalysisFICollapse>();
+    memcpy_test7<PointerAnalysisFICollapse>();
+    memcpy_test8<PointerAnalysisFICollapse>();
+    phi_loop<PointerAnalysisFICollapse>();
+    copy_cycle<PointerAnalysisFICollapse>();
+}
+
+TEST_CASE("Collapsed copy cycle", "FI") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *X = PS.create<PSNodeType::PHI>(A);
+    PSNode *Y = PS.create<PSNodeType::CAST>(X);
+    PSNode *Z = PS.create<PSNodeType::GEP>(Y, 0);
+    PSNode *W = PS.create<PSNodeType::PHI>(Z, B);
+    PSNode *U = PS.create<PSNodeType::CAST>(Y);
+    X->addOperand(W);
+
+    A->addSuccessor(B);
+    B->addSuccessor(X);
+    X->addSuccessor(Y);
+    Y->addSuccessor(Z);
+    Z->addSuccessor(W);
+    W->addSuccessor(X);
+    W->addSuccessor(U);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+    // do not set the offset of the GEP in the loop to unknown,
+    // so that it is a copy node
+    PointerAnalysisFI PA(&PS, dg::PointerAnalysisOptions()
+                                      .setCollapseCycles(true)
+                                      .setPreprocessGeps(false));
+    PA.run();
+
+    // X is the representative that takes the operands of the cycle
+    REQUIRE(PA.getCollapsedNodesNum() == 3);
+    REQUIRE(X->getOperandsNum() == 2);
+    REQUIRE(X->hasOperand(A));
+    REQUIRE(X->hasOperand(B));
+    REQUIRE(Y->getOperandsNum() == 1);
+    REQUIRE(Y->getOperand(0) == X);
+    REQUIRE(Z->getOperand(0) == X);
+    REQUIRE(W->getOperandsNum() == 1);
+    REQUIRE(W->getOperand(0) == X);
+    REQUIRE(U->getOperand(0) == X);
+
+    for (PSNode *n : {X, Y, Z, W, U}) {
+        REQUIRE(n->doesPointsTo(A));
+        REQUIRE(n->doesPointsTo(B));
+        REQUIRE(n->pointsTo.size() == 2);
+    }
+}
+
+TEST_CASE("Copy cycle created during the analysis", "FI") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *F = PS.create<PSNodeType::FUNCTION>();
+    PSNode *C = PS.create<PSNodeType::CALL_FUNCPTR>(F);
+    PSNode *X = PS.create<PSNodeType::PHI>(A);
+    PSNode *Y = PS.create<PSNodeType::CAST>(X);
+    PSNode *W = PS.create<PSNodeType::PHI>(Y);
+    PSNode *V = PS.create<PSNodeType::PHI>(B);
+    PSNode *U = PS.create<PSNodeType::CAST>(W);
+
+    /* the call via pointer adds the operand W to X
+     * (closing the cycle X -> Y -> W -> X) and then
+     * the operand V to the already collapsed node W
+     */
+    A->addSuccessor(B);
+    B->addSuccessor(F);
+    F->addSuccessor(V);
+    V->addSuccessor(C);
+    C->addSuccessor(X);
+    X->addSuccessor(Y);
+    Y->addSuccessor(W);
+    W->addSuccessor(U);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    struct Analysis : public PointerAnalysisFICollapse {
+        PSNode *X, *W, *V;
+        bool addedV{false};
+
+        Analysis(PointerGraph *ps, PSNode *x, PSNode *w, PSNode *v)
+                : PointerAnalysisFICollapse(ps), X(x), W(w), V(v) {}
+
+        bool functionPointerCall(PSNode * /*where*/,
+                                 PSNode * /*what*/) override {
+            X->addOperand(W);
+            return true;
+        }
+
+        bool afterProcessed(PSNode *n) override {
+            bool ret = PointerAnalysisFICollapse::afterProcessed(n);
+            if (n == X && getCollapsedNodesNum() > 0 && !addedV) {
+                W->addOperand(V);
+                addedV = true;
+                enqueue(W);
+            }
+            return ret;
+        }
+    } PA(&PS, X, W, V);
+    PA.run();
+
+    REQUIRE(PA.getCollapsedNodesNum() == 2);
+    REQUIRE(W->getOperandsNum() == 1);
+    REQUIRE(W->getOperand(0) == X);
+    REQUIRE(X->hasOperand(V));
+
+    for (PSNode *n : {X, Y, W, U}) {
+        REQUIRE(n->doesPointsTo(A));
+        REQUIRE(n->doesPointsTo(B));
+        REQUIRE(n->pointsTo.size() == 2);
+    }
+}
+
+TEST_CASE("Flow insensitive with wave propagation", "FI") {
+    store_load<PointerAnalysisFIWave>();
+    store_load2<PointerAnalysisFIWave>();
+    store_load3<PointerAnalysisFIWave>();
+    store_load4<PointerAnalysisFIWave>();
+    store_load5<PointerAnalysisFIWave>();
+    gep1<PointerAnalysisFIWave>();
+    gep2<PointerAnalysisFIWave>();
+    gep3<PointerAnalysisFIWave>();
+    gep4<PointerAnalysisFIWave>();
+    gep5<PointerAnalysisFIWave>();
+    nulltest<PointerAnalysisFIWave>();
+    constant_store<PointerAnalysisFIWave>();
+    load_from_zeroed<PointerAnalysisFIWave>();
+    load_from_unknown_offset<PointerAnalysisFIWave>();
+    load_from_unknown_offset2<PointerAnalysisFIWave>();
+    load_from_unknown_offset3<PointerAnalysisFIWave>();
+    memcpy_test<PointerAnalysisFIWave>();
+    memcpy_test2<PointerAnalysisFIWave>();
+    memcpy_test3<PointerAnalysisFIWave>();
+    memcpy_test4<PointerAnalysisFIWave>();
+    memcpy_test5<PointerAnalysisFIWave>();
+    memcpy_test6<PointerAnalysisFIWave>();
+    memcpy_test7<PointerAnalysisFIWave>();
+    memcpy_test8<PointerAnalysisFIWave>();
+    phi_loop<PointerAnalysisFIWave>();
+    copy_cycle<PointerAnalysisFIWave>();
+}
+
+TEST_CASE("Wave propagation", "FI") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *X1 = PS.create<PSNodeType::PHI>();
+    PSNode *X2 = PS.create<PSNodeType::PHI>();
+    PSNode *X3 = PS.create<PSNodeType::PHI>();
+    PSNode *X4 = PS.create<PSNodeType::PHI>(A);
+    X1->addOperand(X2);
+    X2->addOperand(X3);
+    X3->addOperand(X4);
+
+    /* the pointers flow against the control flow:
+     *    A -> X1 -> X2 -> X3 -> X4
+     *          ^                 |
+     *          +-----------------+
+     */
+    A->addSuccessor(X1);
+    X1->addSuccessor(X2);
+    X2->addSuccessor(X3);
+    X3->addSuccessor(X4);
+    X4->addSuccessor(X1);
+
+    auto *subg = PS.createSubgraph(A);
+    PS.setEntry(subg);
+
+    PointerAnalysisFI BFS(&PS);
+    BFS.run();
+    for (PSNode *n : {X1, X2, X3, X4}) {
+        REQUIRE(n->doesPointsTo(A));
+        REQUIRE(n->pointsTo.size() == 1);
+        n->pointsTo.clear();
+    }
+
+    PointerAnalysisFIWave Wave(&PS);
+    Wave.run();
+    for (PSNode *n : {X1, X2, X3, X4}) {
+        REQUIRE(n->doesPointsTo(A));
+        REQUIRE(n->pointsTo.size() == 1);
+    }
+
+    // the wave propagation processes the PHI nodes in the order
+    // X4, X3, X2, X1, so one iteration is enough to get the fixpoint
+    // (and one more to find out that nothing changed)
+    REQUIRE(Wave.getIterationsNum() == 2);
+    REQUIRE(Wave.getIterationsNum() < BFS.getIterationsNum());
+}
+
+// Build a graph with 'chains' chains of copy nodes that are long enough
+// to be processed by multiple threads. The end of every chain is stored
+// to the memory that is loaded at the beginning of every chain.
+static void buildChains(PointerGraph &PS, unsigned chains, unsigned length) {
+    PSNode *M = PS.create<PSNodeType::ALLOC>();
+    PSNode *L = PS.create<PSNodeType::LOAD>(M);
+    M->addSuccessor(L);
+
+    PSNode *last = L;
+    auto append = [&last](PSNode *n) {
+        last->addSuccessor(n);
+        last = n;
+    };
+
+    for (unsigned c = 0; c < chains; ++c) {
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        append(A);
+        PSNode *prev = PS.create<PSNodeType::PHI>(A, L);
+        append(prev);
+        for (unsigned i = 0; i < length; ++i) {
+            PSNode *C = PS.create<PSNodeType::CAST>(prev);
+            append(C);
+            PSNode *G = PS.create<PSNodeType::GEP>(C, i % 3 == 0 ? 0 : 8);
+            append(G);
+            prev = PS.create<PSNodeType::PHI>(G);
+            append(prev);
+        }
+        append(PS.create<PSNodeType::STORE>(prev, M));
+    }
+
+    // loop back to the load
+    last->addSuccessor(L);
+
+    auto *subg = PS.createSubgraph(M);
+    PS.setEntry(subg);
+}
+
+// the pointers of the node as pairs (target ID, offset), without
+// the pointers that are subsumed by a pointer with unknown offset
+static std::set<std::pair<unsigned, uint64_t>>
+pointsToIDs(const PSNode *n) {
+    std::set<std::pair<unsigned, uint64_t>> ret;
+    for (const auto &ptr : n->pointsTo) {
+        if (ptr.offset.isUnknown() ||
+            !n->pointsTo.has({ptr.target, Offset::UNKNOWN}))
+            ret.emplace(ptr.target->getID(), *ptr.offset);
+    }
+    return ret;
+}
+
+TEST_CASE("Parallel flow insensitive", "FI") {
+    PointerGraph PS1;
+    buildChains(PS1, 16, 50);
+    PointerAnalysisFI PA1(&PS1);
+    PA1.run();
+
+    PointerGraph PS2;
+    buildChains(PS2, 16, 50);
+    PointerAnalysisFI PA2(&PS2, dg::PointerAnalysisOptions()
+                                        .setPreprocessGeps(true)
+                                        .setSolverThreads(4));
+    PA2.run();
+
+    REQUIRE(PS1.getNodes().size() == PS2.getNodes().size());
+    for (size_t i = 0; i < PS1.getNodes().size(); ++i) {
+        const auto &n1 = PS1.getNodes()[i];
+        const auto &n2 = PS2.getNodes()[i];
+        if (!n1) {
+            REQUIRE(!n2);
+            continue;
+        }
+
+        REQUIRE(n1->getType() == n2->getType());
+        REQUIRE(pointsToIDs(n1.get()) == pointsToIDs(n2.get()));
+    }
+}
+
+// the pointers of all nodes of the graph (see pointsToIDs)
+static std::vector<std::set<std::pair<unsigned, uint64_t>>>
+pointsToIDs(const PointerGraph &PS) {
+    std::vector<std::set<std::pair<unsigned, uint64_t>>> ret;
+    for (const auto &nd : PS.getNodes()) {
+        ret.emplace_back();
+        if (nd)
+            ret.back() = pointsToIDs(nd.get());
+    }
+    return ret;
+}
+
+TEST_CASE("Lookup table per graph", "FI") {
+    PointerGraph PS1;
+    buildChains(PS1, 4, 10);
+    PointerAnalysisFI PA1(&PS1);
+    PA1.run();
+
+    const size_t idsNum = PS1.getLookupTable().size();
+    REQUIRE(idsNum > 0);
+    for (const auto &nd : PS1.getNodes()) {
+        if (nd)
+            REQUIRE(&nd->pointsTo.getLookupTable() == &PS1.getLookupTable());
+    }
+
+    // the IDs of another graph do not continue where the first ended
+    PointerGraph PS2;
+    buildChains(PS2, 4, 10);
+    PointerAnalysisFI PA2(&PS2);
+    PA2.run();
+
+    REQUIRE(PS2.getLookupTable().size() == idsNum);
+    REQUIRE(pointsToIDs(PS1) == pointsToIDs(PS2));
+
+    // analyze several graphs in parallel
+    const unsigned threadsNum = 4;
+    std::vector<std::vector<std::set<std::pair<unsigned, uint64_t>>>> results(
+            threadsNum);
+    std::vector<size_t> sizes(threadsNum);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadsNum; ++t) {
+        threads.emplace_back([t, &results, &sizes]() {
+            PointerGraph PS;
+            buildChains(PS, 4, 10);
+            PointerAnalysisFI PA(&PS);
+            PA.run();
+            results[t] = pointsToIDs(PS);
+            sizes[t] = PS.getLookupTable().size();
+        });
+    }
+    for (auto &thr : threads)
+        thr.join();
+
+    for (unsigned t = 0; t < threadsNum; ++t) {
+        REQUIRE(sizes[t] == idsNum);
+        REQUIRE(results[t] == pointsToIDs(PS1));
+    }
 }
 
 TEST_CASE("Flow sensitive", "FS") {
@@ -922,6 +1427,318 @@ TEST_CASE("Flow sensitive", "FS") {
     memcpy_test8<dg::pta::PointerAnalysisFS>();
 }
 
+TEST_CASE("Flow sensitive with wave propagation", "FS") {
+    store_load<PointerAnalysisFSWave>();
+    store_load2<PointerAnalysisFSWave>();
+    store_load3<PointerAnalysisFSWave>();
+    store_load4<PointerAnalysisFSWave>();
+    store_load5<PointerAnalysisFSWave>();
+    gep1<PointerAnalysisFSWave>();
+    gep2<PointerAnalysisFSWave>();
+    gep3<PointerAnalysisFSWave>();
+    gep4<PointerAnalysisFSWave>();
+    gep5<PointerAnalysisFSWave>();
+    nulltest<PointerAnalysisFSWave>();
+    constant_store<PointerAnalysisFSWave>();
+    load_from_zeroed<PointerAnalysisFSWave>();
+    load_from_unknown_offset<PointerAnalysisFSWave>();
+    load_from_unknown_offset2<PointerAnalysisFSWave>();
+    load_from_unknown_offset3<PointerAnalysisFSWave>();
+    memcpy_test<PointerAnalysisFSWave>();
+    memcpy_test2<PointerAnalysisFSWave>();
+    memcpy_test3<PointerAnalysisFSWave>();
+    memcpy_test4<PointerAnalysisFSWave>();
+    memcpy_test5<PointerAnalysisFSWave>();
+    memcpy_test6<PointerAnalysisFSWave>();
+    memcpy_test7<PointerAnalysisFSWave>();
+    memcpy_test8<PointerAnalysisFSWave>();
+}
+
+TEST_CASE("Sparse flow sensitive", "FS") {
+    store_load<PointerAnalysisSFS>();
+    store_load2<PointerAnalysisSFS>();
+    store_load3<PointerAnalysisSFS>();
+    store_load4<PointerAnalysisSFS>();
+    store_load5<PointerAnalysisSFS>();
+    gep1<PointerAnalysisSFS>();
+    gep2<PointerAnalysisSFS>();
+    gep3<PointerAnalysisSFS>();
+    gep4<PointerAnalysisSFS>();
+    gep5<PointerAnalysisSFS>();
+    nulltest<PointerAnalysisSFS>();
+    constant_store<PointerAnalysisSFS>();
+    load_from_zeroed<PointerAnalysisSFS>();
+    load_from_unknown_offset<PointerAnalysisSFS>();
+    load_from_unknown_offset2<PointerAnalysisSFS>();
+    load_from_unknown_offset3<PointerAnalysisSFS>();
+    memcpy_test<PointerAnalysisSFS>();
+    memcpy_test2<PointerAnalysisSFS>();
+    memcpy_test3<PointerAnalysisSFS>();
+    memcpy_test4<PointerAnalysisSFS>();
+    memcpy_test5<PointerAnalysisSFS>();
+    memcpy_test6<PointerAnalysisSFS>();
+    memcpy_test7<PointerAnalysisSFS>();
+    memcpy_test8<PointerAnalysisSFS>();
+}
+
+// Build a random program with branches and loops that stores
+// and loads pointers to a few memory objects
+static void buildRandomProgram(PointerGraph &PS, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::vector<PSNode *> objects;
+    for (unsigned i = 0; i < 4; ++i)
+        objects.push_back(PS.create<PSNodeType::ALLOC>());
+
+    auto *subg = PS.createSubgraph(objects[0]);
+    PS.setEntry(subg);
+
+    PSNode *last = objects[0];
+    auto append = [&last](PSNode *n) {
+        last->addSuccessor(n);
+        last = n;
+    };
+    for (unsigned i = 1; i < objects.size(); ++i)
+        append(objects[i]);
+
+    auto object = [&]() { return objects[gen() % objects.size()]; };
+    // a store or a load (followed by a store or another load)
+    auto access = [&]() {
+        switch (gen() % 3) {
+        case 0:
+            append(PS.create<PSNodeType::STORE>(object(), object()));
+            break;
+        case 1: {
+            PSNode *L = PS.create<PSNodeType::LOAD>(object());
+            append(L);
+            append(PS.create<PSNodeType::STORE>(L, object()));
+            break;
+        }
+        default: {
+            PSNode *L = PS.create<PSNodeType::LOAD>(object());
+            append(L);
+            append(PS.create<PSNodeType::LOAD>(L));
+            break;
+        }
+        }
+    };
+
+    for (unsigned i = 0; i < 30; ++i) {
+        switch (gen() % 4) {
+        case 0: {
+            // if-then-else
+            PSNode *branch = last;
+            access();
+            PSNode *then = last;
+            last = branch;
+            access();
+            PSNode *join = PS.create<PSNodeType::NOOP>();
+            then->addSuccessor(join);
+            append(join);
+            break;
+        }
+        case 1: {
+            // loop, possibly with an allocation
+            PSNode *header = PS.create<PSNodeType::NOOP>();
+            append(header);
+            if (gen() % 2 == 0) {
+                objects.push_back(PS.create<PSNodeType::ALLOC>());
+                append(objects.back());
+            }
+            access();
+            last->addSuccessor(header);
+            last = header;
+            break;
+        }
+        default:
+            access();
+        }
+    }
+}
+
+TEST_CASE("Sparse flow sensitive is as precise as flow sensitive", "FS") {
+    for (unsigned seed = 0; seed < 200; ++seed) {
+        PointerGraph PS1;
+        buildRandomProgram(PS1, seed);
+        PointerAnalysisFS FS(&PS1);
+        FS.run();
+
+        PointerGraph PS2;
+        buildRandomProgram(PS2, seed);
+        PointerAnalysisSFS SFS(&PS2);
+        SFS.run();
+
+        REQUIRE(PS1.getNodes().size() == PS2.getNodes().size());
+        for (size_t i = 0; i < PS1.getNodes().size(); ++i) {
+            // the static nodes
+            if (!PS1.getNodes()[i])
+                continue;
+            REQUIRE(pointsToIDs(PS1.getNodes()[i].get()) ==
+                    pointsToIDs(PS2.getNodes()[i].get()));
+        }
+    }
+}
+
+TEST_CASE("Merging equivalent nodes", "Optimizations") {
+    auto build = [](PointerGraph &PS, std::vector<PSNode *> &N) {
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        PSNode *B = PS.create<PSNodeType::ALLOC>();
+        PSNode *S = PS.create<PSNodeType::STORE>(A, B);
+        PSNode *L1 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *G1 = PS.create<PSNodeType::GEP>(L1, 4);
+        PSNode *L2 = PS.create<PSNodeType::LOAD>(B);
+        PSNode *G2 = PS.create<PSNodeType::GEP>(L2, 4);
+        PSNode *C = PS.create<PSNodeType::CAST>(A);
+        PSNode *P = PS.create<PSNodeType::PHI>(C, A);
+        PSNode *S2 = PS.create<PSNodeType::STORE>(B, B);
+        PSNode *L3 = PS.create<PSNodeType::LOAD>(B);
+        N = {A, B, S, L1, G1, L2, G2, C, P, S2, L3};
+        for (size_t i = 1; i < N.size(); ++i)
+            N[i - 1]->addSuccessor(N[i]);
+        PS.setEntry(PS.createSubgraph(A));
+    };
+
+    SECTION("merge") {
+        PointerGraph PS;
+        std::vector<PSNode *> N;
+        build(PS, N);
+        PSPointerEquivalenceMerger merger(&PS);
+        // L2, G2, C and P, L3 reads memory after another store
+        REQUIRE(merger.run() == 4);
+        const auto &M = merger.getMapping();
+        REQUIRE(M.get(N[5]) == N[3]);
+        REQUIRE(M.get(N[6]) == N[4]);
+        REQUIRE(M.getFinal(N[8]) == N[0]);
+        REQUIRE(PS.getNodes()[N[10]->getID()].get() == N[10]);
+
+        PointerAnalysisFS PA(&PS);
+        PA.run();
+        REQUIRE(N[4]->pointsTo.pointsToTarget(N[0]));
+        REQUIRE(N[4]->pointsTo.size() == 1);
+        REQUIRE(N[10]->doesPointsTo(N[1], 0));
+    }
+
+    SECTION("opaque nodes") {
+        PointerGraph PS;
+        std::vector<PSNode *> N;
+        build(PS, N);
+        PSPointerEquivalenceMerger merger(&PS);
+        // the phi uses the opaque cast, so it is kept too
+        merger.setOpaque(N[7]);
+        REQUIRE(merger.run() == 2);
+        REQUIRE(PS.getNodes()[N[7]->getID()].get() == N[7]);
+        REQUIRE(PS.getNodes()[N[8]->getID()].get() == N[8]);
+    }
+}
+
+TEST_CASE("Merging equivalent nodes keeps the results", "Optimizations") {
+    for (unsigned seed = 0; seed < 100; ++seed) {
+        for (bool flowInsensitive : {true, false}) {
+            PointerGraph PS1;
+            buildRandomProgram(PS1, seed);
+            PointerGraph PS2;
+            buildRandomProgram(PS2, seed);
+
+            std::vector<PSNode *> before;
+            for (const auto &nd : PS2.getNodes())
+                before.push_back(nd.get());
+
+            PSPointerEquivalenceMerger merger(&PS2);
+            merger.run();
+            // the flow-insensitive analysis processes the nodes in
+            // the order of the control flow and its results depend
+            // on the shape of the graph, so check only that
+            // it over-approximates the flow-sensitive analysis
+            PointerAnalysisFS(&PS1).run();
+            if (flowInsensitive)
+                PointerAnalysisFI(&PS2).run();
+            else
+                PointerAnalysisFS(&PS2).run();
+
+            for (size_t i = 0; i < before.size(); ++i) {
+                if (!before[i])
+                    continue;
+                // the removed nodes are mapped to their representants
+                // (the pointers are used only as keys)
+                PSNode *n = PS2.getNodes()[i]
+                                    ? PS2.getNodes()[i].get()
+                                    : merger.getMapping().getFinal(before[i]);
+                const auto orig = pointsToIDs(PS1.getNodes()[i].get());
+                const auto merged = pointsToIDs(n);
+                if (flowInsensitive) {
+                    REQUIRE(std::includes(merged.begin(), merged.end(),
+                                          orig.begin(), orig.end()));
+                } else {
+                    REQUIRE(orig == merged);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Demand-driven analysis", "Demand") {
+    PointerGraph PS;
+    PSNode *A = PS.create<PSNodeType::ALLOC>();
+    PSNode *B = PS.create<PSNodeType::ALLOC>();
+    PSNode *C = PS.create<PSNodeType::ALLOC>();
+    PSNode *D = PS.create<PSNodeType::ALLOC>();
+    PSNode *S1 = PS.create<PSNodeType::STORE>(A, B);
+    PSNode *S2 = PS.create<PSNodeType::STORE>(C, D);
+    PSNode *L = PS.create<PSNodeType::LOAD>(B);
+    PSNode *G = PS.create<PSNodeType::GEP>(L, 4);
+    PSNode *L2 = PS.create<PSNodeType::LOAD>(D);
+    std::vector<PSNode *> nodes{A, B, C, D, S1, S2, L, G, L2};
+    for (size_t i = 1; i < nodes.size(); ++i)
+        nodes[i - 1]->addSuccessor(nodes[i]);
+    PS.setEntry(PS.createSubgraph(A));
+
+    PointerAnalysisDemand PA(&PS);
+    PA.run();
+    REQUIRE(G->pointsTo.empty());
+
+    REQUIRE(PA.query(G));
+    REQUIRE(G->pointsTo.pointsToTarget(A));
+    REQUIRE(G->pointsTo.size() == 1);
+    // the store to D and the load from D were not processed
+    REQUIRE(L2->pointsTo.empty());
+    const size_t relevant = PA.getRelevantNodesNum();
+
+    // answered from the cache
+    REQUIRE(PA.query(L));
+    REQUIRE(PA.getRelevantNodesNum() == relevant);
+
+    REQUIRE(PA.query(L2));
+    REQUIRE(L2->doesPointsTo(C, 0));
+    REQUIRE(PA.getRelevantNodesNum() > relevant);
+}
+
+TEST_CASE("Demand-driven analysis includes flow-insensitive", "Demand") {
+    for (unsigned seed = 0; seed < 100; ++seed) {
+        PointerGraph PS1;
+        buildRandomProgram(PS1, seed);
+        PointerAnalysisFI(&PS1).run();
+
+        PointerGraph PS2;
+        buildRandomProgram(PS2, seed);
+        PointerAnalysisDemand PA(&PS2);
+
+        // query the nodes from the last one, so that the queries
+        // are not answered by the first query only
+        const auto &nodes = PS2.getNodes();
+        for (size_t i = nodes.size(); i-- > 0;) {
+            if (!nodes[i])
+                continue;
+            PA.query(nodes[i].get());
+            // the flow-insensitive analysis may miss the pointers
+            // stored after a load that is not on a loop, the demand-driven
+            // analysis runs until no other node is relevant
+            // and so it may process the load again
+            const auto fi = pointsToIDs(PS1.getNodes()[i].get());
+            const auto dd = pointsToIDs(nodes[i].get());
+            REQUIRE(std::includes(dd.begin(), dd.end(), fi.begin(), fi.end()));
+        }
+    }
+}
+
 TEST_CASE("PSNode test", "PSNode") {
     using namespace dg::pta;
     PointerGraph PS;
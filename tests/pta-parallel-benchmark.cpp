@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "dg/PointerAnalysis/PointerAnalysisFI.h"
+#include "dg/PointerAnalysis/PointerGraph.h"
+#include "dg/util/TimeMeasure.h"
+
+using namespace dg::pta;
+
+// The number of memory cells that the chains store to and load from.
+// Every chain loads from all of them, so the points-to sets grow big.
+static const unsigned CELLS = 8;
+
+// Build 'chains' chains of copy nodes, each of them of 'length' nodes.
+// The chains start with an allocation and loads from the memory cells
+// and end with a store to one of the cells.
+static void buildGraph(PointerGraph &PS, unsigned chains, unsigned length) {
+    std::vector<PSNode *> cells;
+    std::vector<PSNode *> loads;
+    PSNode *last = PS.create<PSNodeType::NOOP>();
+    PSNode *root = last;
+    auto append = [&last](PSNode *n) {
+        last->addSuccessor(n);
+        last = n;
+    };
+
+    for (unsigned i = 0; i < CELLS; ++i) {
+        PSNode *M = PS.create<PSNodeType::ALLOC>();
+        append(M);
+        cells.push_back(M);
+    }
+
+    PSNode *head = nullptr;
+    for (PSNode *M : cells) {
+        PSNode *L = PS.create<PSNodeType::LOAD>(M);
+        append(L);
+        if (!head)
+            head = L;
+        loads.push_back(L);
+    }
+
+    for (unsigned c = 0; c < chains; ++c) {
+        PSNode *A = PS.create<PSNodeType::ALLOC>();
+        append(A);
+        PSNode *prev = PS.create<PSNodeType::PHI>(A);
+        for (PSNode *L : loads)
+            prev->addOperand(L);
+        append(prev);
+
+        for (unsigned i = 0; i < length; ++i) {
+            PSNode *C = PS.create<PSNodeType::CAST>(prev);
+            append(C);
+            PSNode *G = PS.create<PSNodeType::GEP>(C, 0);
+            append(G);
+            prev = PS.create<PSNodeType::PHI>(G);
+            append(prev);
+        }
+
+        append(PS.create<PSNodeType::STORE>(prev, cells[c % CELLS]));
+    }
+
+    // loop back to the loads
+    last->addSuccessor(head);
+
+    auto *subg = PS.createSubgraph(root);
+    PS.setEntry(subg);
+}
+
+int main(int argc, char *argv[]) {
+    // usage: pta-parallel-benchmark [chains] [length] [max threads]
+    unsigned chains = 100;
+    unsigned length = 50;
+    if (argc > 1)
+        chains = std::atoi(argv[1]);
+    if (argc > 2)
+        length = std::atoi(argv[2]);
+
+    unsigned maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    if (argc > 3)
+        maxThreads = std::atoi(argv[3]);
+
+    std::cout << "Flow-insensitive PTA on " << chains << " chains of "
+              << length << " nodes\n";
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        PointerGraph PS;
+        buildGraph(PS, chains, length);
+
+        // the GEPs have zero offsets, do not search for loops
+        // (it is recursive and would overflow the stack)
+        PointerAnalysisFI PA(&PS, dg::PointerAnalysisOptions()
+                                          .setPreprocessGeps(false)
+                                          .setSolverThreads(threads));
+
+        dg::debug::TimeMeasure tm;
+        tm.start();
+        PA.run();
+        tm.stop();
+
+        std::cout << "Running with " << threads << " threads ("
+                  << PA.getIterationsNum() << " iterations)\n";
+        tm.report(" -- took");
+    }
+}
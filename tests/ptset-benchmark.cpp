@@ -1,3 +1,5 @@
+#include <cstdlib>
+#include <new>
 #include <random>
 #include <string>
 #include <vector>
@@ -7,6 +9,33 @@
 
 using namespace dg::pta;
 
+// count the allocated memory, so that we can compare
+// how much memory the sets take
+static size_t allocatedBytes = 0;
+
+void *operator new(size_t size) {
+    // keep the size of the allocation before the memory
+    auto *mem = static_cast<size_t *>(std::malloc(size + sizeof(max_align_t)));
+    if (!mem)
+        std::abort();
+    *mem = size;
+    allocatedBytes += size;
+    return reinterpret_cast<char *>(mem) + sizeof(max_align_t);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (!ptr)
+        return;
+    auto *mem = reinterpret_cast<size_t *>(static_cast<char *>(ptr) -
+                                           sizeof(max_align_t));
+    allocatedBytes -= *mem;
+    std::free(mem);
+}
+
+void operator delete(void *ptr, size_t /* size */) noexcept {
+    operator delete(ptr);
+}
+
 std::default_random_engine generator;
 std::uniform_int_distribution<uint64_t> distribution(0,
                                                      ~static_cast<uint64_t>(0));
@@ -21,6 +50,20 @@ std::uniform_int_distribution<uint64_t> distribution(0,
         tm.stop();                                                             \
         tm.report(" -- PointsToSet bitvector took");                           \
         tm.start();                                                            \
+        for (int i = 0; i < times; ++i)                                        \
+            func<ChunkedPointerIdPointsToSet>();                               \
+        tm.stop();                                                             \
+        tm.report(" -- PointsToSet chunked bitvector took");                   \
+        tm.start();                                                            \
+        for (int i = 0; i < times; ++i) {                                      \
+            /* the diagrams are freed with the table */                        \
+            dg::PointerIDLookupTable table;                                    \
+            dg::PointerIDLookupTable::Binding bind(table);                     \
+            func<BDDPointsToSet>();                                            \
+        }                                                                      \
+        tm.stop();                                                             \
+        tm.report(" -- PointsToSet BDD took");                                 \
+        tm.start();                                                            \
         for (int i = 0; i < times; ++i)                                        \
             func<SimplePointsToSet>();                                         \
         tm.stop();                                                             \
@@ -80,10 +123,70 @@ void test5() {
 
     PTSetT S;
     for (int i = 0; i < 1000; ++i) {
-        S.add(reinterpret_cast<PSNode *>(i), i);
+        S.add(reinterpret_cast<PSNode *>(i + 1), i);
     }
 }
 
+// merge sets of dense pointers as the analysis does
+template <typename PTSetT>
+void test6() {
+    std::vector<PTSetT> sets(20);
+    for (size_t i = 0; i < sets.size(); ++i) {
+        for (int j = 0; j < 100; ++j) {
+            auto x = distribution(generator) % 500;
+            sets[i].add(reinterpret_cast<PSNode *>(x + 1), 0);
+        }
+    }
+
+    PTSetT S;
+    for (int k = 0; k < 10; ++k) {
+        for (const auto &s : sets)
+            S.add(s);
+    }
+}
+
+// keep many big sets that differ only in few pointers,
+// as the sets of pointers in a program often do
+template <typename PTSetT>
+size_t memory() {
+    dg::PointerIDLookupTable table;
+    dg::PointerIDLookupTable::Binding bind(table);
+    // assign the IDs first, so that we count only the sets
+    for (int j = 0; j < 1000; ++j)
+        table.getOrCreate({reinterpret_cast<PSNode *>(j + 1), 0});
+
+    size_t before = allocatedBytes;
+    // the sets get the common pointers by merging as in the analysis
+    PTSetT common;
+    for (int j = 0; j < 200; ++j)
+        common.add(reinterpret_cast<PSNode *>(j + 1), 0);
+
+    std::vector<PTSetT> sets(1000);
+    for (auto &S : sets) {
+        S.add(common);
+        for (int j = 0; j < 10; ++j) {
+            auto x = distribution(generator) % 1000;
+            S.add(reinterpret_cast<PSNode *>(x + 1), 0);
+        }
+    }
+    return allocatedBytes - before;
+}
+
+#define runMemory(msg)                                                         \
+    do {                                                                       \
+        std::cout << "Memory of " << (msg) << "\n";                            \
+        std::cout << " -- PointsToSet bitvector: " << memory<PointsToSetT>()   \
+                  << " B\n";                                                   \
+        std::cout << " -- PointsToSet chunked bitvector: "                     \
+                  << memory<ChunkedPointerIdPointsToSet>() << " B\n";          \
+        std::cout << " -- PointsToSet BDD: " << memory<BDDPointsToSet>()       \
+                  << " B\n";                                                   \
+        std::cout << " -- PointsToSet shared: "                                \
+                  << memory<SharedPointsToSet>() << " B\n";                    \
+        std::cout << " -- PointsToSet std::set: "                              \
+                  << memory<SimplePointsToSet>() << " B\n";                    \
+    } while (0);
+
 int main() {
     int times;
     times = 100000;
@@ -100,4 +203,9 @@ int main() {
 
     times = 10000;
     run(test5, "Adding 1000 different pointers");
+
+    times = 1000;
+    run(test6, "Merging 20 sets of 100 pointers 10 times");
+
+    runMemory("1000 sets of 210 pointers with 200 common pointers");
 }
@@ -518,6 +518,12 @@ class ModuleAnnotator {
         case AnalysisType::svf:
             module_comment += "SVF\n";
             break;
+        case AnalysisType::sfs:
+            module_comment += "sparse flow-sensitive\n";
+            break;
+        case AnalysisType::demand:
+            module_comment += "demand-driven flow-insensitive\n";
+            break;
         }
 
         module_comment += ";   * PTA field sensitivity: ";
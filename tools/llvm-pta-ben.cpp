@@ -367,6 +367,9 @@ int main(int argc, char *argv[]) {
 
     tm.stop();
     tm.report("INFO: Pointer analysis took");
+    std::cerr << "INFO: Pointer analysis reached fixpoint after "
+              << PTA.getPTA()->getIterationsNum() << " iterations"
+              << std::endl;
 
     evalPTA(&PTA);
 
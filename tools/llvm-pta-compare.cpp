@@ -1,8 +1,11 @@
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/LLVMContext.h>
@@ -51,15 +54,77 @@ llvm::cl::opt<bool>
 llvm::cl::opt<bool> fi("fi", llvm::cl::desc("Run flow-insensitive PTA."),
                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> fi_diff(
+        "fi-diff",
+        llvm::cl::desc("Run flow-insensitive PTA with difference propagation."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_collapse(
+        "fi-collapse",
+        llvm::cl::desc("Run flow-insensitive PTA with collapsing of copy "
+                       "cycles."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_merge(
+        "fi-merge",
+        llvm::cl::desc("Run flow-insensitive PTA with merging of equivalent "
+                       "nodes."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_summarize(
+        "fi-summarize",
+        llvm::cl::desc("Run flow-insensitive PTA without building "
+                       "the functions that do not work with pointers."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_summaries(
+        "fi-summaries",
+        llvm::cl::desc("Run flow-insensitive PTA that builds the calls of "
+                       "functions that do not write to memory "
+                       "from their summaries."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_cs(
+        "fi-cs",
+        llvm::cl::desc("Run flow-insensitive PTA with cloning of allocation "
+                       "wrappers (-pta-context-sensitivity, 1 if not set)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_wave(
+        "fi-wave",
+        llvm::cl::desc("Run flow-insensitive PTA with wave propagation."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool> fi_parallel(
+        "fi-parallel",
+        llvm::cl::desc("Run flow-insensitive PTA in multiple threads "
+                       "(-pta-solver-threads or all available)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 llvm::cl::opt<bool> fs("fs", llvm::cl::desc("Run flow-sensitive PTA."),
                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> fs_merge(
+        "fs-merge",
+        llvm::cl::desc("Run flow-sensitive PTA with merging of equivalent "
+                       "nodes."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 llvm::cl::opt<bool> fsinv(
         "fsinv",
         llvm::cl::desc(
                 "Run flow-sensitive PTA with invalidated memory analysis."),
         llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
 
+llvm::cl::opt<bool> sfs("sfs",
+                        llvm::cl::desc("Run sparse flow-sensitive PTA."),
+                        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+llvm::cl::opt<bool>
+        demand("demand",
+               llvm::cl::desc("Run demand-driven flow-insensitive PTA."),
+               llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
 #if HAVE_SVF
 llvm::cl::opt<bool> svf("svf", llvm::cl::desc("Run SVF PTA (Andersen)."),
                         llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
@@ -117,12 +182,18 @@ static bool verify_ptsets(const llvm::Value *val, const std::string &N1,
     //    llvm::errs() << N2 << "  unknown\n";
     //}
 
+    // the iterators of LLVMPointsToSet share the state,
+    // so we cannot iterate over ptset2 in a nested loop
+    std::vector<LLVMPointer> pointers2;
+    for (const auto &ptr2 : ptset2)
+        pointers2.push_back(ptr2);
+
     for (const auto &ptr : ptset1) {
         bool found = false;
         if (unknown_covers && ptset2.hasUnknown()) {
             found = true;
         } else {
-            for (const auto &ptr2 : ptset2) {
+            for (const auto &ptr2 : pointers2) {
                 if (ptr == ptr2) {
                     found = true;
                     break;
@@ -208,18 +279,107 @@ int main(int argc, char *argv[]) {
                 "DG FI", createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts),
                 0);
     }
+    if (fi_diff) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.diffPropagation = true;
+        analyses.emplace_back(
+                "DG FI (diff)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.diffPropagation = false;
+    }
+    if (fi_collapse) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.collapseCycles = true;
+        analyses.emplace_back(
+                "DG FI (collapse)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.collapseCycles = false;
+    }
+    if (fi_merge) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.mergeEquivalentNodes = true;
+        analyses.emplace_back(
+                "DG FI (merge)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.mergeEquivalentNodes = false;
+    }
+    if (fi_summarize) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.summarizePointerFree = true;
+        analyses.emplace_back(
+                "DG FI (summarize)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.summarizePointerFree = false;
+    }
+    if (fi_summaries) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.summaries = true;
+        analyses.emplace_back(
+                "DG FI (summaries)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.summaries = false;
+    }
+    if (fi_cs) {
+        const unsigned k = opts.contextSensitivity;
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.contextSensitivity = std::max(1U, k);
+        analyses.emplace_back(
+                "DG FI (context-sensitive)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.contextSensitivity = k;
+    }
+    if (fi_wave) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        opts.scheduler = dg::PointerAnalysisOptions::Scheduler::WAVE;
+        analyses.emplace_back(
+                "DG FI (wave)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.scheduler = dg::PointerAnalysisOptions::Scheduler::BFS;
+    }
+    if (fi_parallel) {
+        const unsigned threadsNum = opts.solverThreads;
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fi;
+        if (opts.solverThreads <= 1)
+            opts.solverThreads =
+                    std::max(2U, std::thread::hardware_concurrency());
+        analyses.emplace_back(
+                "DG FI (parallel)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.solverThreads = threadsNum;
+    }
     if (fs) {
         opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fs;
         analyses.emplace_back(
                 "DG FS", createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts),
                 0);
     }
+    if (fs_merge) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::fs;
+        opts.mergeEquivalentNodes = true;
+        analyses.emplace_back(
+                "DG FS (merge)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+        opts.mergeEquivalentNodes = false;
+    }
     if (fsinv) {
         opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::inv;
         analyses.emplace_back(
                 "DG FSinv",
                 createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
     }
+    if (sfs) {
+        opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::sfs;
+        analyses.emplace_back(
+                "DG SFS", createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts),
+                0);
+    }
+    if (demand) {
+        opts.analysisType =
+                dg::LLVMPointerAnalysisOptions::AnalysisType::demand;
+        analyses.emplace_back(
+                "DG FI (demand)",
+                createAnalysis<DGLLVMPointerAnalysis>(M.get(), opts), 0);
+    }
 #ifdef HAVE_SVF
     if (svf) {
         opts.analysisType = dg::LLVMPointerAnalysisOptions::AnalysisType::svf;
@@ -247,9 +407,11 @@ int main(int argc, char *argv[]) {
     int ret = 0;
     for (auto &analysis1 : analyses) {
         for (auto &analysis2 : analyses) {
-            ret = !verify_ptsets(
-                    M.get(), std::get<0>(analysis1), std::get<0>(analysis2),
-                    std::get<1>(analysis1).get(), std::get<1>(analysis2).get());
+            if (!verify_ptsets(M.get(), std::get<0>(analysis1),
+                               std::get<0>(analysis2),
+                               std::get<1>(analysis1).get(),
+                               std::get<1>(analysis2).get()))
+                ret = 1;
         }
     }
 
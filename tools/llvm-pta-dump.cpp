@@ -262,7 +262,7 @@ static void dumpPointer(const Pointer &ptr, bool dot) {
         printf(" + %" PRIu64, *ptr.offset);
 }
 
-static void dumpMemoryObject(MemoryObject *mo, int ind, bool dot) {
+static void dumpMemoryObject(const MemoryObject *mo, int ind, bool dot) {
     bool printed_multi = false;
     for (auto &it : mo->pointsTo) {
         int width = 0;
@@ -337,7 +337,13 @@ static bool mmChanged(PSNode *n) {
 
 static void dumpPointerGraphData(PSNode *n, PTType type, bool dot = false) {
     assert(n && "No node given");
-    if (type == dg::LLVMPointerAnalysisOptions::AnalysisType::fi) {
+    // the sparse analysis does not keep the memory in the nodes
+    // (the nodes have the memory from the flow-insensitive stage)
+    if (type == dg::LLVMPointerAnalysisOptions::AnalysisType::sfs)
+        return;
+
+    if (type == dg::LLVMPointerAnalysisOptions::AnalysisType::fi ||
+        type == dg::LLVMPointerAnalysisOptions::AnalysisType::demand) {
         MemoryObject *mo = n->getData<MemoryObject>();
         if (!mo)
             return;
@@ -764,6 +770,29 @@ static void dumpStats(DGLLVMPointerAnalysis *pta) {
     printf("Pointing to stack: %zu\n", pointing_to_stack);
     printf("Pointing to function: %zu\n", pointing_to_function);
     printf("Maximum pt-set size: %zu\n", maximum);
+
+    if (pta->getOptions().isFS() || pta->getOptions().isFSInv()) {
+        // the memory objects are shared between the memory maps
+        std::set<const PointerAnalysisFS::MemoryMapT *> maps;
+        std::set<const MemoryObject *> objects;
+        size_t entries = 0;
+        for (const auto &node : nodes) {
+            if (!node)
+                continue;
+
+            const auto *mm = node->getData<PointerAnalysisFS::MemoryMapT>();
+            if (!mm || !maps.insert(mm).second)
+                continue;
+
+            entries += mm->size();
+            for (const auto &it : *mm)
+                objects.insert(it.second.get());
+        }
+
+        printf("Memory maps: %zu\n", maps.size());
+        printf("Memory maps entries: %zu\n", entries);
+        printf("Memory objects: %zu\n", objects.size());
+    }
 }
 
 int main(int argc, char *argv[]) {
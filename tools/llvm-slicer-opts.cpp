@@ -162,6 +162,74 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
             llvm::cl::value_desc("N"), llvm::cl::init(dg::Offset::UNKNOWN),
             llvm::cl::cat(SlicingOpts));
 
+    llvm::cl::opt<bool> ptaDiffPropagation(
+            "pta-diff-propagation",
+            llvm::cl::desc("Propagate only changes of points-to sets in PTA "
+                           "(difference propagation). Default: false.\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ptaCollapseCycles(
+            "pta-collapse-cycles",
+            llvm::cl::desc("Collapse cycles of copy nodes in flow-insensitive "
+                           "PTA. Default: false.\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ptaMergeEquivalent(
+            "pta-merge-equivalent",
+            llvm::cl::desc("Merge nodes that must have the same points-to "
+                           "sets before running PTA (offline variable "
+                           "substitution). Default: false.\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ptaSummarizePointerFree(
+            "pta-summarize-pointer-free",
+            llvm::cl::desc("Do not build the functions that do not work with "
+                           "pointers, treat their calls as no-ops. "
+                           "Default: false.\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ptaSummaries(
+            "pta-summaries",
+            llvm::cl::desc("Do not build the functions that do not write "
+                           "to memory, build their calls from summaries "
+                           "of the returned pointers. Default: false.\n"),
+            llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<std::string> ptaSummaryCache(
+            "pta-summary-cache",
+            llvm::cl::desc("Read and store the summaries of functions "
+                           "in the given file (implies -pta-summaries).\n"),
+            llvm::cl::value_desc("FILE"), llvm::cl::init(""),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaContextSensitivity(
+            "pta-context-sensitivity",
+            llvm::cl::desc("Clone allocation wrappers for call sites, "
+                           "up to call strings of the given length "
+                           "(k-callsite sensitivity). Default: 0 (off).\n"),
+            llvm::cl::value_desc("K"), llvm::cl::init(0),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<dg::PointerAnalysisOptions::Scheduler> ptaScheduler(
+            "pta-scheduler",
+            llvm::cl::desc("Choose the order in which PTA processes nodes:"),
+            llvm::cl::values(
+                    clEnumValN(dg::PointerAnalysisOptions::Scheduler::BFS,
+                               "bfs", "BFS order of the graph (default)"),
+                    clEnumValN(dg::PointerAnalysisOptions::Scheduler::WAVE,
+                               "wave",
+                               "Topological order of the constraint graph "
+                               "(wave propagation)")),
+            llvm::cl::init(dg::PointerAnalysisOptions::Scheduler::BFS),
+            llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaSolverThreads(
+            "pta-solver-threads",
+            llvm::cl::desc("The number of threads used by flow-insensitive "
+                           "PTA. Default: 1.\n"),
+            llvm::cl::value_desc("N"), llvm::cl::init(1),
+            llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<dg::dda::UndefinedFunsBehavior> undefinedFunsBehavior(
             "undefined-funs",
             llvm::cl::desc("Set the behavior of undefined functions\n"),
@@ -232,7 +300,15 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
                     clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fs,
                                "fs", "Flow-sensitive PTA"),
                     clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv,
-                               "inv", "PTA with invalidate nodes")
+                               "inv", "PTA with invalidate nodes"),
+                    clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::sfs,
+                               "sfs",
+                               "Sparse flow-sensitive PTA (runs flow-insensitive "
+                               "PTA first)"),
+                    clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::demand,
+                               "demand",
+                               "Demand-driven flow-insensitive PTA (computes "
+                               "only the queried points-to sets)")
 #ifdef HAVE_SVF
                             ,
                     clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::svf,
@@ -420,6 +496,15 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[], bool requireCrit,
     PTAOptions.fieldSensitivity = dg::Offset(ptaFieldSensitivity);
     PTAOptions.analysisType = ptaType;
     PTAOptions.threads = threads;
+    PTAOptions.diffPropagation = ptaDiffPropagation;
+    PTAOptions.collapseCycles = ptaCollapseCycles;
+    PTAOptions.mergeEquivalentNodes = ptaMergeEquivalent;
+    PTAOptions.summarizePointerFree = ptaSummarizePointerFree;
+    PTAOptions.summaries = ptaSummaries;
+    PTAOptions.summaryCache = ptaSummaryCache;
+    PTAOptions.contextSensitivity = ptaContextSensitivity;
+    PTAOptions.scheduler = ptaScheduler;
+    PTAOptions.solverThreads = ptaSolverThreads;
 
     DDAOptions.threads = threads;
     DDAOptions.entryFunction = entryFunction;